@@ -0,0 +1,127 @@
+#include "core_sim.h"
+#include "engines.h"
+#include <sched.h>
+#include <time.h>
+
+// The hash core model is not reentrant: one chunk at a time across the simulated cores.
+static pthread_mutex_t model_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Helper functions
+ */
+// -------------------------------------------------------------------------------------
+
+static double thread_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *core_thread(void *argument)
+{
+    SimCore *core = argument;
+
+    pthread_mutex_lock(&core->lock);
+    for (;;) {
+        while (core->chunk == NULL && !core->stop) pthread_cond_wait(&core->wake, &core->lock);
+        if (core->stop) break;
+        const LzwChunk *chunk = core->chunk;
+        pthread_mutex_unlock(&core->lock);
+
+        uint32_t compressed_size = 0;
+        uint64_t cycles = 0;
+        double cpu = 0;
+        if (chunk->length > 0) {
+            double start = thread_seconds();
+            lzw_compress_sw_r(&core->dictionary, (uint8_t *)chunk->input, chunk->output, (int)chunk->length,
+                              &compressed_size);
+            cpu = thread_seconds() - start;
+
+            // Same stream: the model rewrites the output with the bytes the core would write.
+            pthread_mutex_lock(&model_lock);
+            compressed_size = (uint32_t)engine_hls_hash.compress(chunk->input, chunk->length, chunk->output, &cycles);
+            pthread_mutex_unlock(&model_lock);
+        }
+
+        pthread_mutex_lock(&core->lock);
+        core->compressed_size = compressed_size;
+        core->busy_seconds = (double)cycles / SIM_CORE_CLOCK_HZ;
+        core->cpu_seconds += cpu;
+        core->chunk = NULL;
+        core->done = 1;
+    }
+    pthread_mutex_unlock(&core->lock);
+    return NULL;
+}
+
+static void sim_start(void *handle, const LzwChunk *chunk)
+{
+    SimCore *core = handle;
+    pthread_mutex_lock(&core->lock);
+    core->chunk = chunk;
+    core->done = 0;
+    pthread_cond_signal(&core->wake);
+    pthread_mutex_unlock(&core->lock);
+}
+
+static int sim_is_done(void *handle)
+{
+    SimCore *core = handle;
+    pthread_mutex_lock(&core->lock);
+    int done = core->done;
+    pthread_mutex_unlock(&core->lock);
+
+    // The orchestrator polls in a tight loop: leave the CPU to the core threads while they work.
+    if (!done) sched_yield();
+    return done;
+}
+
+static void sim_collect(void *handle, LzwChunk *chunk)
+{
+    SimCore *core = handle;
+    pthread_mutex_lock(&core->lock);
+    chunk->compressed_size = core->compressed_size;
+    chunk->busy_seconds = core->busy_seconds;
+    pthread_mutex_unlock(&core->lock);
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Global variables
+ */
+// -------------------------------------------------------------------------------------
+
+// Host memory is coherent: no cache maintenance around the chunks.
+const LzwCoreOps sim_core_ops = {sim_start, sim_is_done, sim_collect, NULL, NULL};
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// -------------------------------------------------------------------------------------
+
+int SimCore_create(SimCore *core)
+{
+    core->chunk = NULL;
+    core->done = 0;
+    core->stop = 0;
+    core->compressed_size = 0;
+    core->busy_seconds = 0;
+    core->cpu_seconds = 0;
+    pthread_mutex_init(&core->lock, NULL);
+    pthread_cond_init(&core->wake, NULL);
+    return pthread_create(&core->thread, NULL, core_thread, core);
+}
+
+void SimCore_destroy(SimCore *core)
+{
+    pthread_mutex_lock(&core->lock);
+    core->stop = 1;
+    pthread_cond_signal(&core->wake);
+    pthread_mutex_unlock(&core->lock);
+    pthread_join(core->thread, NULL);
+    pthread_mutex_destroy(&core->lock);
+    pthread_cond_destroy(&core->wake);
+}
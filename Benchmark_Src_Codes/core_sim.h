@@ -0,0 +1,55 @@
+#ifndef CORE_SIM_H
+#define CORE_SIM_H
+
+#include "orchestrator.h"
+#include "lzw_compress_sw.h"
+#include <pthread.h>
+
+/*
+ * Threaded stand-in for an lzw_compress IP core, driven through the same LzwCoreOps as the XLzw_compress
+ * instances of the Multiple IPs application. Each simulated core is one thread that compresses its chunk
+ * with the C model of the hash core (engine_hls_hash) and raises a done flag. The busy time of a chunk is
+ * the LZW_PERF_CYCLES of the model at SIM_CORE_CLOCK_HZ, the time the core takes on the board whatever the
+ * host CPUs. The model keeps its dictionary in static memory, so the model runs of the cores are serialized,
+ * which only slows the host down.
+ * The CPU time of lzw_compress_sw_r on the same chunk (same stream, own dictionary per core) is kept as a
+ * secondary figure in cpu_seconds.
+ */
+#ifndef SIM_CORE_CLOCK_HZ
+#define SIM_CORE_CLOCK_HZ 100000000     // Clock of the lzw_compress core (FCLK_CLK0 of the block design)
+#endif
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    const LzwChunk *chunk;          // Chunk being compressed, NULL when idle
+    int done;
+    int stop;
+    uint32_t compressed_size;       // Results of the last chunk
+    double busy_seconds;
+    double cpu_seconds;             // CPU time of lzw_compress_sw_r, summed over the chunks since SimCore_create
+    LzwSwDictionary dictionary;
+} SimCore;
+
+extern const LzwCoreOps sim_core_ops;
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// ------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the thread of a simulated core, idle until sim_core_ops.start hands it a chunk.
+ *
+ * @return 0 on success, non-zero if the thread could not be created.
+ */
+int SimCore_create(SimCore *core);
+
+/**
+ * @brief Stops and joins the thread of a simulated core. The core must be idle.
+ */
+void SimCore_destroy(SimCore *core);
+
+#endif
@@ -0,0 +1,141 @@
+#include "corpus.h"
+#include <stdio.h>
+#include <string.h>
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Helper functions
+ */
+// -------------------------------------------------------------------------------------
+
+static uint32_t next_random(uint32_t *state)
+{
+    // xorshift32: fast, and the same sequence on every platform.
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/* Appends a string, truncated at the end of the buffer */
+static size_t put_string(uint8_t *buffer, size_t pos, size_t size, const char *text)
+{
+    while (*text && pos < size) buffer[pos++] = (uint8_t)*text++;
+    return pos;
+}
+
+static const char *const words[] = {
+    "the", "of", "and", "to", "in", "a", "is", "that", "for", "it", "as", "was", "with", "be", "by", "on",
+    "not", "he", "this", "are", "or", "his", "from", "at", "which", "but", "have", "an", "had", "they",
+    "compression", "dictionary", "prefix", "code", "stream", "memory", "engine", "hardware", "buffer",
+    "throughput", "latency", "pipeline", "bandwidth", "algorithm", "table", "entry", "collision", "width",
+    "internship", "board", "report", "result", "design", "measure", "output", "input", "block", "cycle"};
+
+static void generate_text(uint8_t *buffer, size_t size, uint32_t *state)
+{
+    const size_t count = sizeof(words) / sizeof(words[0]);
+    size_t pos = 0, line = 0;
+    int sentence_start = 1;
+
+    while (pos < size) {
+        // Two draws with the minimum kept: the first words of the table come up far more often.
+        uint32_t a = next_random(state) % count, b = next_random(state) % count;
+        const char *word = words[a < b ? a : b];
+        size_t start = pos;
+
+        pos = put_string(buffer, pos, size, word);
+        if (sentence_start && start < size && buffer[start] >= 'a') buffer[start] -= 'a' - 'A';
+        sentence_start = 0;
+        line += pos - start;
+
+        uint32_t r = next_random(state) % 16;
+        const char *separator = (r == 0) ? ". " : (r == 1) ? ", " : " ";
+        if (r == 0) sentence_start = 1;
+        if (line > 72) {
+            separator = (r == 0) ? ".\n" : "\n";
+            line = 0;
+        }
+        pos = put_string(buffer, pos, size, separator);
+    }
+}
+
+static void generate_logs(uint8_t *buffer, size_t size, uint32_t *state)
+{
+    static const char *const levels[] = {"INFO ", "INFO ", "INFO ", "DEBUG", "WARN ", "ERROR"};
+    static const char *const paths[] = {"/index.html", "/api/v1/jobs", "/static/app.js", "/status", "/upload"};
+    uint32_t seconds = 36000, job = 1000;
+    size_t pos = 0;
+    char line[160];
+
+    while (pos < size) {
+        seconds += next_random(state) % 3;
+        job += 1 + next_random(state) % 2;
+        uint32_t r = next_random(state);
+        uint32_t in = 4096 * (1 + r % 4), out = in / 2 + (next_random(state) % 512);
+        snprintf(line, sizeof(line), "2024-05-02 %02u:%02u:%02u %s lzw[%u] job %u %s %u -> %u bytes\n",
+                 (seconds / 3600) % 24, (seconds / 60) % 60, seconds % 60, levels[r % 6], 1200 + r % 8, job,
+                 paths[(r >> 8) % 5], in, out);
+        pos = put_string(buffer, pos, size, line);
+    }
+}
+
+static void generate_binary(uint8_t *buffer, size_t size, uint32_t *state)
+{
+    uint32_t address = 0x10000000;
+    size_t pos = 0;
+
+    // 32-byte records: id, address, flags, a small signed value, a length, padding.
+    for (uint32_t id = 0; pos < size; id++) {
+        uint32_t fields[8] = {id, address, 0x00000001u << (next_random(state) % 4),
+                              (uint32_t)((int32_t)(next_random(state) % 200) - 100), next_random(state) % 4096, 0, 0,
+                              next_random(state) % 8 == 0 ? next_random(state) : 0};
+        address += 16 * (1 + next_random(state) % 8);
+        for (int f = 0; f < 8 && pos < size; f++) {
+            for (int b = 0; b < 4 && pos < size; b++) buffer[pos++] = (uint8_t)(fields[f] >> (8 * b));
+        }
+    }
+}
+
+static void generate_random(uint8_t *buffer, size_t size, uint32_t *state)
+{
+    for (size_t pos = 0; pos < size; pos++) buffer[pos] = (uint8_t)(next_random(state) >> 24);
+}
+
+static void generate_runs(uint8_t *buffer, size_t size, uint32_t *state)
+{
+    size_t pos = 0;
+    while (pos < size) {
+        uint8_t value = (uint8_t)(next_random(state) % 16);
+        size_t length = 1;
+        while (length < 4096 && (next_random(state) & 31) != 0) length++;
+        for (size_t i = 0; i < length && pos < size; i++) buffer[pos++] = value;
+    }
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// -------------------------------------------------------------------------------------
+
+const char *Corpus_name(CorpusKind kind)
+{
+    static const char *const names[CORPUS_COUNT] = {"text", "logs", "binary", "random", "runs"};
+    return (kind < CORPUS_COUNT) ? names[kind] : "file";
+}
+
+void Corpus_generate(CorpusKind kind, uint8_t *buffer, size_t size, uint32_t seed)
+{
+    uint32_t state = seed ? seed : 1;
+
+    switch (kind) {
+    case CORPUS_TEXT:   generate_text(buffer, size, &state); break;
+    case CORPUS_LOGS:   generate_logs(buffer, size, &state); break;
+    case CORPUS_BINARY: generate_binary(buffer, size, &state); break;
+    case CORPUS_RANDOM: generate_random(buffer, size, &state); break;
+    case CORPUS_RUNS:   generate_runs(buffer, size, &state); break;
+    default:            memset(buffer, 0, size); break;
+    }
+}
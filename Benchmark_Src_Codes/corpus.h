@@ -0,0 +1,45 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Generated inputs, reproducible from a seed so that runs on different machines compress the same bytes.
+ *   text    English-like words with a skewed word frequency, punctuation and line breaks
+ *   logs    Timestamped application log lines (levels, job ids, paths, sizes)
+ *   binary  Little-endian records: small integers, increasing addresses, zero padding
+ *   random  Uniform bytes, the LZW worst case (a dictionary reset every 3840 codes)
+ *   runs    Runs of one byte with geometric lengths, the LZW best case
+ */
+typedef enum {
+    CORPUS_TEXT,
+    CORPUS_LOGS,
+    CORPUS_BINARY,
+    CORPUS_RANDOM,
+    CORPUS_RUNS,
+    CORPUS_COUNT
+} CorpusKind;
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// ------------------------------------------------------------------------------------
+
+/**
+ * @brief Name of a corpus kind, as printed in the results.
+ */
+const char *Corpus_name(CorpusKind kind);
+
+/**
+ * @brief Fills buffer with size bytes of the given kind.
+ *
+ * @param kind      Corpus kind.
+ * @param buffer    Output buffer.
+ * @param size      Bytes to generate.
+ * @param seed      Generator seed, the same seed gives the same bytes.
+ */
+void Corpus_generate(CorpusKind kind, uint8_t *buffer, size_t size, uint32_t seed);
+
+#endif
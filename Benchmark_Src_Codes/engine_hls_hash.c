@@ -0,0 +1,14 @@
+#include "engines.h"
+#include "../HLS_src_codes/ZedBoard/HASH Version/functions.h"
+
+static size_t hls_hash_compress(const uint8_t *input, size_t size, uint8_t *output, uint64_t *model_cycles)
+{
+    uint32_t compression_size = 0, input_crc = 0, output_crc = 0;
+    uint32_t perf_counters[LZW_PERF_COUNT] = {0};
+
+    lzw_compress((uint8_t *)input, output, (int)size, &compression_size, &input_crc, &output_crc, perf_counters);
+    *model_cycles = perf_counters[LZW_PERF_CYCLES];
+    return compression_size;
+}
+
+const Engine engine_hls_hash = {"hls_hash", 1, 0, hls_hash_compress, NULL};
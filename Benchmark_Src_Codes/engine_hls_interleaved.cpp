@@ -0,0 +1,49 @@
+#include "engines.h"
+#include "../HLS_src_codes/ZedBoard/Interleaved Compression Version/functions.h"
+
+/* One context per chunk; inputs and 2 * len + 4 byte output buffers word aligned, as in the testbench. */
+static size_t hls_interleaved_compress(const uint8_t *input, size_t size, uint8_t *output, uint64_t *model_cycles)
+{
+    LzwDescriptor descriptors[LZW_CONTEXTS];
+    size_t offset = 0;
+
+    for (uint32_t i = 0; i < LZW_CONTEXTS; i++) {
+        size_t chunk_offset, length;
+        Engine_chunk(size, LZW_CONTEXTS, i, &chunk_offset, &length);
+        descriptors[i].src = offset;
+        descriptors[i].len = length;
+        descriptors[i].dst = offset + ((length + 3) & ~(size_t)3);
+        descriptors[i].size_out = 0;
+        offset = descriptors[i].dst + ((2 * length + 4 + 3) & ~(size_t)3);
+    }
+
+    size_t words = offset / 4;
+    ap_uint<32> *memory = new ap_uint<32>[words];
+    for (size_t i = 0; i < words; i++) memory[i] = 0;
+    for (uint32_t i = 0; i < LZW_CONTEXTS; i++) {
+        size_t chunk_offset, length;
+        Engine_chunk(size, LZW_CONTEXTS, i, &chunk_offset, &length);
+        for (size_t j = 0; j < length; j++) {
+            size_t word = (descriptors[i].src + j) / 4, lane = (descriptors[i].src + j) % 4;
+            memory[word] = memory[word] | (ap_uint<32>(input[chunk_offset + j]) << (8 * lane));
+        }
+    }
+
+    Interleave_model_reset();
+    top_interleaved_lzw(descriptors, memory);
+
+    size_t out = 0;
+    for (uint32_t i = 0; i < LZW_CONTEXTS; i++) {
+        for (uint32_t j = 0; j < descriptors[i].size_out; j++) {
+            size_t word = (descriptors[i].dst + j) / 4, lane = (descriptors[i].dst + j) % 4;
+            output[out++] = (memory[word] >> (8 * lane)) & 0xFF;
+        }
+    }
+
+    const LzwInterleaveModel *model = Interleave_model_get();
+    *model_cycles = model->compute_cycles + model->burst_cycles;
+    delete[] memory;
+    return out;
+}
+
+extern "C" const Engine engine_hls_interleaved = {"hls_interleaved", LZW_CONTEXTS, 0, hls_interleaved_compress, NULL};
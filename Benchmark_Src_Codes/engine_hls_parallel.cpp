@@ -0,0 +1,48 @@
+#include "engines.h"
+#include "../HLS_src_codes/ZedBoard/Parallel Compression Same IP Core/functions.h"
+
+/*
+ * Same memory layout as the csim corpus mode of the testbench: the input from offset 0, then one word
+ * aligned output buffer of 2 * len bytes (rounded up) per engine.
+ */
+static size_t hls_parallel_compress(const uint8_t *input, size_t size, uint8_t *output, uint64_t *model_cycles)
+{
+    LzwDescriptor descriptors[NUMBER_PARALLEL_FUNCTIONS];
+    size_t total_words = (size + MEMORY_WORD_BYTES - 1) / MEMORY_WORD_BYTES;
+
+    for (uint32_t i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        size_t offset, length;
+        Engine_chunk(size, NUMBER_PARALLEL_FUNCTIONS, i, &offset, &length);
+        descriptors[i].src = offset;
+        descriptors[i].len = length;
+        descriptors[i].dst = total_words * MEMORY_WORD_BYTES;
+        descriptors[i].size_out = 0;
+        descriptors[i].cycles = 0;
+        total_words += (2 * length + MEMORY_WORD_BYTES - 1) / MEMORY_WORD_BYTES + 1;
+    }
+
+    MemoryWord *memory = new MemoryWord[total_words];
+    for (size_t i = 0; i < total_words; i++) memory[i] = 0;
+    for (size_t i = 0; i < size; i++) {
+        memory[i / MEMORY_WORD_BYTES].range(8 * (i % MEMORY_WORD_BYTES) + 7, 8 * (i % MEMORY_WORD_BYTES)) = input[i];
+    }
+
+    Model_reset();
+    top_parallel_lzw(descriptors, memory, memory);
+
+    size_t out = 0;
+    for (uint32_t i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        for (uint32_t j = 0; j < descriptors[i].size_out; j++) {
+            uint32_t addr = descriptors[i].dst + j;
+            output[out++] = memory[addr / MEMORY_WORD_BYTES].range(8 * (addr % MEMORY_WORD_BYTES) + 7, 8 * (addr % MEMORY_WORD_BYTES));
+        }
+    }
+
+    const LzwCycleModel *model = Model_get();
+    *model_cycles = model->compute_cycles + model->burst_cycles;
+
+    delete[] memory;
+    return out;
+}
+
+extern "C" const Engine engine_hls_parallel = {"hls_parallel", NUMBER_PARALLEL_FUNCTIONS, 0, hls_parallel_compress, NULL};
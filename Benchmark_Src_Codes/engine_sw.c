@@ -0,0 +1,43 @@
+/*
+ * The two software compressors: Sw_Src_Codes/Compression (built with LZW_HOSTED), decoded by
+ * Sw_Src_Codes/Decompression (engine_sw_decoder.c), and the lzw_compress_sw of the user-level
+ * applications, which has no software decoder.
+ */
+#include "engines.h"
+#include "../Sw_Src_Codes/Compression/functions.h"
+#include "../User_level_application/Common/lzw_compress_sw.h"
+
+extern uint8_t bitstream[];
+extern size_t bitstream_index;
+
+size_t sw_decoder_decompress(const uint8_t *input, size_t size, uint8_t *output, size_t capacity);
+
+/* data[] holds 100000 bytes and bitstream[] 49152: 12-bit codes need up to 1.5 bytes per input byte */
+#define SW_REFERENCE_MAX_INPUT 32768
+
+static size_t sw_reference_compress(const uint8_t *input, size_t size, uint8_t *output, uint64_t *model_cycles)
+{
+    memcpy(data, input, size);
+    data_len = size;
+    Dictionary_init();
+    compress();
+
+    size_t compression_size = (bitstream_index + 7) / 8;
+    memcpy(output, bitstream, compression_size);
+    *model_cycles = 0;
+    return compression_size;
+}
+
+static size_t user_sw_compress(const uint8_t *input, size_t size, uint8_t *output, uint64_t *model_cycles)
+{
+    uint32_t compression_size = 0;
+
+    // lzw_compress_sw reads input[0] even for an empty input.
+    if (size == 0) return 0;
+    lzw_compress_sw((uint8_t *)input, output, (int)size, &compression_size);
+    *model_cycles = 0;
+    return compression_size;
+}
+
+const Engine engine_sw_reference = {"sw_reference", 1, SW_REFERENCE_MAX_INPUT, sw_reference_compress, sw_decoder_decompress};
+const Engine engine_user_sw = {"user_sw", 1, 0, user_sw_compress, NULL};
@@ -0,0 +1,27 @@
+/*
+ * The Sw_Src_Codes/Decompression decoder (built with LZW_HOSTED), which reads the stream of the
+ * Sw_Src_Codes compressor. Both use the same global names (data, dictionary, Dictionary_init, ...), so
+ * this file and the decoder are linked into one object that exports only sw_decoder_decompress (see
+ * the build commands in main.c).
+ */
+#include "../Sw_Src_Codes/Decompression/function.h"
+#include <string.h>
+
+/* output[] holds MAX_DICT_SIZE * 12 bytes, data[] 100000 */
+#define SW_DECODER_MAX_OUTPUT (MAX_DICT_SIZE * 12)
+
+size_t sw_decoder_decompress(const uint8_t *input, size_t size, uint8_t *output_buffer, size_t capacity)
+{
+    if (size == 0 || size > sizeof(data)) return 0;
+
+    memcpy(data, input, size);
+    data_len = size;
+    Dictionary_init();
+    decompress();
+
+    size_t length = output_index;
+    if (length > capacity) length = capacity;
+    if (length > SW_DECODER_MAX_OUTPUT) length = SW_DECODER_MAX_OUTPUT;
+    memcpy(output_buffer, output, length);
+    return length;
+}
@@ -0,0 +1,79 @@
+#ifndef ENGINES_H
+#define ENGINES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Every LZW compressor of the repository behind one interface. The HLS cores run as C-simulation
+ * (the same sources Vitis compiles for csim), the software ones as built for the boards with
+ * LZW_HOSTED replacing the SD card and BSP headers.
+ *
+ * Engines that split their input (the parallel and interleaved cores) cut it like the HLS
+ * testbenches do, in `chunks` equal parts with the remainder spread over the first ones, and
+ * return the compressed chunks back to back. The balanced split of the host applications
+ * (Partition_split) is measured by scaling.c.
+ */
+
+/* Output bytes an engine may write for an input of n bytes: 12-bit codes for every byte plus padding */
+#define ENGINE_OUTPUT_BOUND(n, chunks) (2 * (size_t)(n) + 16 * (size_t)(chunks) + 16)
+
+typedef struct {
+    const char *name;
+    uint32_t chunks;            // Independent streams the input is cut into, 1 for a single stream
+    uint32_t max_input;         // Largest input the engine holds, 0 for no limit
+    /**
+     * @brief Compresses input.
+     *
+     * @param input         Input buffer.
+     * @param size          Input size in bytes.
+     * @param output        Output buffer of ENGINE_OUTPUT_BOUND(size, chunks) bytes.
+     * @param model_cycles  Busy cycles given by the cycle model of an HLS core, 0 for the software engines.
+     *
+     * @return Compressed size in bytes.
+     */
+    size_t (*compress)(const uint8_t *input, size_t size, uint8_t *output, uint64_t *model_cycles);
+    /**
+     * @brief Decompresses what compress wrote, NULL for the engines without a software decoder.
+     *
+     * @param input         Compressed stream.
+     * @param size          Compressed size in bytes.
+     * @param output        Output buffer.
+     * @param capacity      Output buffer size in bytes.
+     *
+     * @return Decompressed size in bytes.
+     */
+    size_t (*decompress)(const uint8_t *input, size_t size, uint8_t *output, size_t capacity);
+} Engine;
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Engines
+ */
+// ------------------------------------------------------------------------------------
+
+extern const Engine engine_hls_hash;          // HLS_src_codes/ZedBoard/HASH Version, the reference stream
+extern const Engine engine_hls_parallel;      // HLS_src_codes/ZedBoard/Parallel Compression Same IP Core
+extern const Engine engine_hls_interleaved;   // HLS_src_codes/ZedBoard/Interleaved Compression Version
+extern const Engine engine_sw_reference;      // Sw_Src_Codes/Compression
+extern const Engine engine_user_sw;           // User_level_application/Common/lzw_compress_sw.c
+
+/**
+ * @brief Position of one chunk when size bytes are cut in chunks equal parts, as the HLS testbenches do.
+ */
+static inline void Engine_chunk(size_t size, uint32_t chunks, uint32_t index, size_t *offset, size_t *length)
+{
+    size_t part = size / chunks, remainder = size % chunks;
+    *offset = part * index + (index < remainder ? index : remainder);
+    *length = part + (index < remainder ? 1 : 0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
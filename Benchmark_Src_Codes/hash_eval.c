@@ -0,0 +1,594 @@
+/*
+ * Dictionary hash functions and table layouts, measured on recorded dictionary operations:
+ *   hash_eval record TRACE [--size BYTES] [file ...]
+ *   hash_eval replay [--json] TRACE ...
+ *
+ * record parses the inputs (the generated corpora when no file is given) with the semantics of the
+ * lzw_compress core, on an exact table, and writes the operation stream the dictionary sees: one lookup
+ * per input byte, a hit or a miss followed by the insert of the missed string, and the resets of the full
+ * dictionary. The stream does not depend on the hash, so one trace replays against every candidate.
+ *
+ * replay runs every hash function on every table layout of the HASH Version core:
+ *   double    4096 slots, double hashing (hash1 + i * hash2), the linear layout of the core and lzw_compress_sw
+ *   linear    4096 slots, linear probing
+ *   scan      4096 slots, linear probing that never stops on a free slot (Sw_Src_Codes Dictionary_find)
+ *   bucketed  2048 buckets x 4 ways, one probe per lookup, inserts into a full bucket are dropped
+ *   cuckoo    2 x 4096 slots and a 4-entry stash, up to 16 kicks per insert
+ * and reports the probes per hit, per miss and per insert, the longest probe, the kicks, the hits lost to
+ * dropped inserts (a ratio loss on the board) and the cycles per byte of the core: one cycle per byte, one
+ * more per extra probe and per kick, and a table clear per reset. The recent-pair cache of the core is not
+ * modelled. The hash functions:
+ *   shift_xor       hash1/hash2 of the cores, multiplicative for the bucketed and cuckoo layouts
+ *   sw_shift_xor    ((prefix << 5) ^ ext) % 4096 of Sw_Src_Codes, hash2 of the cores
+ *   multiplicative  key * 2654435761, hash1 = top 12 bits, hash2 = next 12 bits | 1
+ *   crc             CRC-32 (reflected) of the 20-bit key, bits used as above
+ *   tabulation      XOR of three random tables indexed by the prefix bytes and the extension
+ * LZW_HASH_FUNCTION selects shift_xor (sw_shift_xor in Sw_Src_Codes), multiplicative or crc in the HASH,
+ * Parallel and Interleaved cores and the software compressors.
+ *
+ * Build from the repository root:
+ *   gcc -O2 Benchmark_Src_Codes/hash_eval.c Benchmark_Src_Codes/corpus.c -o hash_eval
+ */
+#include "corpus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define EVAL_DICTIONARY_SIZE 4096
+#define EVAL_SEED 2024
+#define EVAL_RECORD_SIZE (1 << 20)      // Bytes per generated corpus
+
+/* Trace file: the header, then one uint32_t per operation, prefix | ext << 12 | op << 20 */
+#define TRACE_OPS_MAGIC 0x4F57524Cu     // "LZWO"
+#define OP_HIT 0                        // Lookup found the string
+#define OP_MISS 1                       // Lookup missed, the string is inserted with the next code
+#define OP_RESET 2                      // Dictionary full: the next miss clears it before its insert
+#define OP_START 3                      // New input: empty dictionary, its first byte is the prefix
+
+#define BUCKET_BITS 11
+#define BUCKET_WAYS 4
+#define CUCKOO_BITS 12
+#define CUCKOO_MAX_KICKS 16
+#define STASH_SIZE 4
+
+typedef struct {
+    uint32_t magic;
+    uint32_t count;
+} TraceOpsHeader;
+
+typedef struct {
+    const char *name;
+    uint32_t (*mix)(uint32_t key);                          // 32-bit hash of prefix | ext << 12
+    uint32_t (*first)(uint32_t key, uint32_t mix);          // hash1
+    uint32_t (*step)(uint32_t key, uint32_t mix);           // hash2, odd
+} HashFunction;
+
+typedef enum { LAYOUT_DOUBLE, LAYOUT_LINEAR, LAYOUT_SCAN, LAYOUT_BUCKETED, LAYOUT_CUCKOO, LAYOUT_COUNT } Layout;
+
+static const char *const layout_names[LAYOUT_COUNT] = {"double", "linear", "scan", "bucketed", "cuckoo"};
+
+typedef struct {
+    uint64_t bytes;
+    uint64_t hits, misses, inserts;
+    uint64_t hit_probes, miss_probes, insert_probes;
+    uint64_t max_probes;
+    uint64_t kicks;
+    uint64_t lost_hits;         // Hits of the trace the layout could not find (dropped insert)
+    uint64_t extra_cycles;      // Cycles beyond one per byte
+} ReplayStats;
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Hash functions
+ */
+// -------------------------------------------------------------------------------------
+
+static uint32_t tabulation_tables[3][256];
+
+static uint32_t mix_multiplicative(uint32_t key) { return key * 2654435761u; }
+
+static uint32_t mix_crc(uint32_t key)
+{
+    uint32_t crc = key;
+    for (int i = 0; i < 20; i++) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    return crc;
+}
+
+static uint32_t mix_tabulation(uint32_t key)
+{
+    return tabulation_tables[0][key & 0xFF] ^ tabulation_tables[1][(key >> 8) & 0x0F] ^
+           tabulation_tables[2][(key >> 12) & 0xFF];
+}
+
+static uint32_t first_shift_xor(uint32_t key, uint32_t mix)
+{
+    (void)mix;
+    return (((key & 0xFFF) << 8) ^ (key >> 12)) & (EVAL_DICTIONARY_SIZE - 1);
+}
+
+static uint32_t first_sw_shift_xor(uint32_t key, uint32_t mix)
+{
+    (void)mix;
+    return (((key & 0xFFF) << 5) ^ (key >> 12)) % EVAL_DICTIONARY_SIZE;
+}
+
+static uint32_t step_shift_xor(uint32_t key, uint32_t mix)
+{
+    (void)mix;
+    return ((((key & 0xFFF) << 5) ^ ((key >> 12) * 7)) & (EVAL_DICTIONARY_SIZE - 1)) | 1;
+}
+
+static uint32_t first_mix(uint32_t key, uint32_t mix)
+{
+    (void)key;
+    return mix >> 20;
+}
+
+static uint32_t step_mix(uint32_t key, uint32_t mix)
+{
+    (void)key;
+    return ((mix >> 8) & (EVAL_DICTIONARY_SIZE - 1)) | 1;
+}
+
+static const HashFunction functions[] = {
+    {"shift_xor", mix_multiplicative, first_shift_xor, step_shift_xor},
+    {"sw_shift_xor", mix_multiplicative, first_sw_shift_xor, step_shift_xor},
+    {"multiplicative", mix_multiplicative, first_mix, step_mix},
+    {"crc", mix_crc, first_mix, step_mix},
+    {"tabulation", mix_tabulation, first_mix, step_mix},
+};
+#define FUNCTION_COUNT (sizeof(functions) / sizeof(functions[0]))
+
+/* Second cuckoo bank, the same for every function as in the core (hash_cuckoo1) */
+static uint32_t cuckoo_second(uint32_t key)
+{
+    return ((key ^ (key >> 7)) * 0x85EBCA6Bu) >> (32 - CUCKOO_BITS);
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Record
+ */
+// -------------------------------------------------------------------------------------
+
+/*
+ * Exact dictionary: one slot per (prefix, ext), stamped with the generation (number of clears) it was
+ * written in, so a reset is a counter increment instead of a 4 MB clear.
+ */
+typedef struct {
+    uint32_t *slots;            // generation << 16 | code
+    uint32_t generation;
+    FILE *file;
+    uint32_t count;
+    uint64_t compressed_bits;   // Output size of the parse, checked against lzw_compress_sw
+} Recorder;
+
+static void emit(Recorder *recorder, uint32_t prefix, uint32_t ext, uint32_t op)
+{
+    uint32_t word = prefix | (ext << 12) | (op << 20);
+    fwrite(&word, sizeof(word), 1, recorder->file);
+    recorder->count++;
+}
+
+static void record_input(Recorder *recorder, const uint8_t *input, size_t size)
+{
+    if (size == 0) return;
+
+    uint32_t dictionary_size = 256, bit_count = 8;
+    uint32_t prefix = input[0];
+    recorder->generation++;
+    emit(recorder, prefix, 0, OP_START);
+
+    for (size_t i = 1; i < size; i++) {
+        uint32_t ext = input[i];
+        uint32_t slot = recorder->slots[(prefix << 8) | ext];
+        if ((slot >> 16) == recorder->generation) {
+            emit(recorder, prefix, ext, OP_HIT);
+            prefix = slot & 0xFFFF;
+            continue;
+        }
+
+        recorder->compressed_bits += bit_count;
+        if (dictionary_size >= EVAL_DICTIONARY_SIZE) {
+            emit(recorder, 0, 0, OP_RESET);
+            recorder->generation++;
+            dictionary_size = 256;
+            bit_count = 8;
+        }
+        emit(recorder, prefix, ext, OP_MISS);
+        if (dictionary_size >= (1u << bit_count)) bit_count++;
+        recorder->slots[(prefix << 8) | ext] = (recorder->generation << 16) | dictionary_size++;
+        prefix = ext;
+    }
+    recorder->compressed_bits += bit_count;
+    recorder->compressed_bits = (recorder->compressed_bits + 7) & ~(uint64_t)7;
+}
+
+static int record(const char *path, size_t size, char **files, int file_count)
+{
+    Recorder recorder = {calloc((size_t)EVAL_DICTIONARY_SIZE * 256, sizeof(uint32_t)), 0, fopen(path, "wb"), 0, 0};
+    TraceOpsHeader header = {TRACE_OPS_MAGIC, 0};
+
+    if (recorder.file == NULL) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, recorder.file);
+
+    if (file_count == 0) {
+        uint8_t *input = malloc(size ? size : 1);
+        for (int kind = 0; kind < CORPUS_COUNT; kind++) {
+            uint64_t before = recorder.compressed_bits;
+            Corpus_generate(kind, input, size, EVAL_SEED + kind);
+            record_input(&recorder, input, size);
+            fprintf(stderr, "%s: %zu bytes, %llu compressed\n", Corpus_name(kind), size,
+                    (unsigned long long)(recorder.compressed_bits - before) / 8);
+        }
+        free(input);
+    }
+
+    for (int f = 0; f < file_count; f++) {
+        FILE *file = fopen(files[f], "rb");
+        if (file == NULL) {
+            fprintf(stderr, "Cannot open %s\n", files[f]);
+            continue;
+        }
+        fseek(file, 0, SEEK_END);
+        size_t length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        uint8_t *input = malloc(length + 1);
+        if (fread(input, 1, length, file) != length) length = 0;
+        fclose(file);
+
+        uint64_t before = recorder.compressed_bits;
+        record_input(&recorder, input, length);
+        fprintf(stderr, "%s: %zu bytes, %llu compressed\n", files[f], length,
+                (unsigned long long)(recorder.compressed_bits - before) / 8);
+        free(input);
+    }
+
+    header.count = recorder.count;
+    fseek(recorder.file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, recorder.file);
+    fclose(recorder.file);
+    free(recorder.slots);
+    fprintf(stderr, "%u operations written to %s\n", recorder.count, path);
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Replay
+ */
+// -------------------------------------------------------------------------------------
+
+/* Table of one layout: entries are code << 20 | key, 0 for a free slot (codes start at 256) */
+typedef struct {
+    uint32_t slots[2 * EVAL_DICTIONARY_SIZE];
+    uint32_t stash[STASH_SIZE];
+    uint32_t rows;              // Rows cleared by a reset, one cycle each
+} Table;
+
+static void table_clear(Table *table)
+{
+    memset(table->slots, 0, sizeof(table->slots));
+    memset(table->stash, 0, sizeof(table->stash));
+}
+
+static int entry_matches(uint32_t entry, uint32_t key) { return entry != 0 && (entry & 0xFFFFF) == key; }
+
+static void count_probes(ReplayStats *stats, uint64_t *total, uint32_t probes)
+{
+    *total += probes;
+    if (probes > stats->max_probes) stats->max_probes = probes;
+}
+
+/**
+ * @brief Looks key up. For the probing layouts, *slot receives the free slot a miss stopped on.
+ *
+ * @return Non-zero when found.
+ */
+static int table_find(Table *table, Layout layout, const HashFunction *hash, uint32_t key, uint32_t *slot,
+                      uint32_t *probes)
+{
+    uint32_t mix = hash->mix(key);
+
+    switch (layout) {
+    case LAYOUT_BUCKETED: {
+        uint32_t bucket = mix >> (32 - BUCKET_BITS);
+        *probes = 1;
+        *slot = bucket;
+        for (int w = 0; w < BUCKET_WAYS; w++) {
+            if (entry_matches(table->slots[bucket * BUCKET_WAYS + w], key)) return 1;
+        }
+        return 0;
+    }
+    case LAYOUT_CUCKOO: {
+        uint32_t s0 = mix >> (32 - CUCKOO_BITS), s1 = cuckoo_second(key);
+        *probes = 1;
+        *slot = s0;
+        if (entry_matches(table->slots[s0], key)) return 1;
+        if (entry_matches(table->slots[EVAL_DICTIONARY_SIZE + s1], key)) return 1;
+        for (int i = 0; i < STASH_SIZE; i++) {
+            if (entry_matches(table->stash[i], key)) return 1;
+        }
+        return 0;
+    }
+    default: {
+        uint32_t first = hash->first(key, mix);
+        uint32_t step = (layout == LAYOUT_DOUBLE) ? hash->step(key, mix) : 1;
+        uint32_t free_slot = EVAL_DICTIONARY_SIZE;
+        for (uint32_t i = 0; i < EVAL_DICTIONARY_SIZE; i++) {
+            uint32_t idx = (first + i * step) & (EVAL_DICTIONARY_SIZE - 1);
+            uint32_t entry = table->slots[idx];
+            if (entry_matches(entry, key)) {
+                *probes = i + 1;
+                return 1;
+            }
+            if (entry == 0) {
+                if (free_slot == EVAL_DICTIONARY_SIZE) free_slot = idx;
+                if (layout != LAYOUT_SCAN) {
+                    *probes = i + 1;
+                    *slot = idx;
+                    return 0;
+                }
+            }
+        }
+        *probes = EVAL_DICTIONARY_SIZE;
+        *slot = free_slot;
+        return 0;
+    }
+    }
+}
+
+/**
+ * @brief Inserts key with code after a miss that stopped on slot.
+ *
+ * @return Slots visited (scan layout) or kicks (cuckoo layout); *placed is zero when the entry was dropped.
+ */
+static uint32_t table_insert(Table *table, Layout layout, const HashFunction *hash, uint32_t key, uint32_t code,
+                             uint32_t slot, int *placed)
+{
+    uint32_t entry = (code << 20) | key;
+    *placed = 1;
+
+    switch (layout) {
+    case LAYOUT_BUCKETED:
+        for (int w = 0; w < BUCKET_WAYS; w++) {
+            if (table->slots[slot * BUCKET_WAYS + w] == 0) {
+                table->slots[slot * BUCKET_WAYS + w] = entry;
+                return 0;
+            }
+        }
+        *placed = 0;
+        return 0;
+    case LAYOUT_CUCKOO: {
+        uint32_t s1 = EVAL_DICTIONARY_SIZE + cuckoo_second(key);
+        if (table->slots[slot] == 0) {
+            table->slots[slot] = entry;
+            return 0;
+        }
+        if (table->slots[s1] == 0) {
+            table->slots[s1] = entry;
+            return 0;
+        }
+        // Same displacement as Dictionary_kick: the victim moves to its slot in the other bank.
+        uint32_t moving = entry, addr = slot, kicks = 0;
+        for (;;) {
+            uint32_t victim = table->slots[addr];
+            table->slots[addr] = moving;
+            kicks++;
+            if (victim == 0) return kicks;
+            uint32_t victim_key = victim & 0xFFFFF;
+            moving = victim;
+            addr = (addr >= EVAL_DICTIONARY_SIZE) ? hash->mix(victim_key) >> (32 - CUCKOO_BITS)
+                                                  : EVAL_DICTIONARY_SIZE + cuckoo_second(victim_key);
+            if (kicks >= CUCKOO_MAX_KICKS) break;
+        }
+        for (int i = 0; i < STASH_SIZE; i++) {
+            if (table->stash[i] == 0) {
+                table->stash[i] = moving;
+                return kicks;
+            }
+        }
+        *placed = 0;
+        return kicks;
+    }
+    case LAYOUT_SCAN: {
+        // Dictionary_add of Sw_Src_Codes probes again from the first slot.
+        uint32_t first = hash->first(key, hash->mix(key));
+        for (uint32_t i = 0; i < EVAL_DICTIONARY_SIZE; i++) {
+            uint32_t idx = (first + i) & (EVAL_DICTIONARY_SIZE - 1);
+            if (table->slots[idx] == 0) {
+                table->slots[idx] = entry;
+                return i + 1;
+            }
+        }
+        *placed = 0;
+        return EVAL_DICTIONARY_SIZE;
+    }
+    default:
+        table->slots[slot] = entry;
+        return 1;
+    }
+}
+
+static void replay(const uint32_t *ops, uint32_t count, Layout layout, const HashFunction *hash, Table *table,
+                   ReplayStats *stats)
+{
+    uint32_t dictionary_size = 256, slot = 0;
+    int reset_pending = 0;
+
+    memset(stats, 0, sizeof(*stats));
+    table->rows = (layout == LAYOUT_BUCKETED) ? (1u << BUCKET_BITS) : EVAL_DICTIONARY_SIZE;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t op = ops[i] >> 20, key = ops[i] & 0xFFFFF, probes;
+
+        if (op == OP_START) {
+            table_clear(table);
+            stats->extra_cycles += table->rows + 1;
+            stats->bytes++;
+            dictionary_size = 256;
+            reset_pending = 0;
+            continue;
+        }
+        if (op == OP_RESET) {
+            reset_pending = 1;
+            continue;
+        }
+
+        stats->bytes++;
+        int found = table_find(table, layout, hash, key, &slot, &probes);
+        if (layout != LAYOUT_BUCKETED && layout != LAYOUT_CUCKOO) stats->extra_cycles += probes - 1;
+
+        if (op == OP_HIT) {
+            stats->hits++;
+            count_probes(stats, &stats->hit_probes, probes);
+            if (!found) stats->lost_hits++;
+            continue;
+        }
+
+        stats->misses++;
+        count_probes(stats, &stats->miss_probes, probes);
+
+        // As in the core, the lookup sees the full table and the insert an empty one.
+        if (reset_pending) {
+            table_clear(table);
+            stats->extra_cycles += table->rows + 1;
+            dictionary_size = 256;
+            reset_pending = 0;
+            table_find(table, layout, hash, key, &slot, &probes);
+        }
+        int placed;
+        uint32_t work = table_insert(table, layout, hash, key, dictionary_size++, slot, &placed);
+        stats->inserts++;
+        if (layout == LAYOUT_CUCKOO) {
+            stats->kicks += work;
+            stats->extra_cycles += work;
+        } else if (layout == LAYOUT_SCAN) {
+            count_probes(stats, &stats->insert_probes, work);
+        } else {
+            stats->insert_probes += 1;
+        }
+    }
+}
+
+static uint32_t *read_trace(const char *path, uint32_t *count)
+{
+    FILE *file = fopen(path, "rb");
+    TraceOpsHeader header;
+    if (file == NULL || fread(&header, sizeof(header), 1, file) != 1 || header.magic != TRACE_OPS_MAGIC) {
+        fprintf(stderr, "%s is not an operation trace\n", path);
+        if (file) fclose(file);
+        return NULL;
+    }
+    uint32_t *ops = malloc((size_t)header.count * sizeof(uint32_t) + 1);
+    *count = (uint32_t)fread(ops, sizeof(uint32_t), header.count, file);
+    fclose(file);
+    return ops;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double ratio(uint64_t a, uint64_t b) { return b ? (double)a / b : 0.0; }
+
+static int replay_all(int json, char **paths, int path_count)
+{
+    Table *table = malloc(sizeof(Table));
+    int rows = 0;
+
+    if (json) printf("[\n");
+    else printf("trace,function,layout,hits,misses,hit_probes,miss_probes,insert_probes,max_probes,kicks_per_insert,"
+                "lost_hits,cycles_per_byte,ns_per_op\n");
+
+    for (int p = 0; p < path_count; p++) {
+        uint32_t count;
+        uint32_t *ops = read_trace(paths[p], &count);
+        if (ops == NULL) continue;
+        const char *name = strrchr(paths[p], '/');
+        name = name ? name + 1 : paths[p];
+
+        for (int l = 0; l < LAYOUT_COUNT; l++) {
+            for (size_t f = 0; f < FUNCTION_COUNT; f++) {
+                ReplayStats s;
+                double start = now_seconds();
+                replay(ops, count, (Layout)l, &functions[f], table, &s);
+                double ns_per_op = count ? (now_seconds() - start) * 1e9 / count : 0.0;
+                double cycles_per_byte = ratio(s.bytes + s.extra_cycles, s.bytes);
+
+                if (json) {
+                    printf("%s  {\"trace\": \"%s\", \"function\": \"%s\", \"layout\": \"%s\", \"hits\": %llu, "
+                           "\"misses\": %llu, \"hit_probes\": %.3f, \"miss_probes\": %.3f, \"insert_probes\": %.3f, "
+                           "\"max_probes\": %llu, \"kicks_per_insert\": %.3f, \"lost_hits\": %llu, "
+                           "\"cycles_per_byte\": %.4f, \"ns_per_op\": %.2f}",
+                           rows ? ",\n" : "", name, functions[f].name, layout_names[l], (unsigned long long)s.hits,
+                           (unsigned long long)s.misses, ratio(s.hit_probes, s.hits), ratio(s.miss_probes, s.misses),
+                           ratio(s.insert_probes, s.inserts), (unsigned long long)s.max_probes,
+                           ratio(s.kicks, s.inserts), (unsigned long long)s.lost_hits, cycles_per_byte, ns_per_op);
+                } else {
+                    printf("%s,%s,%s,%llu,%llu,%.3f,%.3f,%.3f,%llu,%.3f,%llu,%.4f,%.2f\n", name, functions[f].name,
+                           layout_names[l], (unsigned long long)s.hits, (unsigned long long)s.misses,
+                           ratio(s.hit_probes, s.hits), ratio(s.miss_probes, s.misses),
+                           ratio(s.insert_probes, s.inserts), (unsigned long long)s.max_probes,
+                           ratio(s.kicks, s.inserts), (unsigned long long)s.lost_hits, cycles_per_byte, ns_per_op);
+                }
+                rows++;
+                fflush(stdout);
+            }
+        }
+        free(ops);
+    }
+
+    if (json) printf("\n]\n");
+    free(table);
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                        Main
+ */
+// -------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    // Fixed tables, so that the tabulation results are reproducible.
+    uint32_t state = EVAL_SEED;
+    for (int t = 0; t < 3; t++) {
+        for (int i = 0; i < 256; i++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            tabulation_tables[t][i] = state;
+        }
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "record") == 0) {
+        size_t size = EVAL_RECORD_SIZE;
+        char **files = malloc(argc * sizeof(char *));
+        int file_count = 0;
+        for (int i = 3; i < argc; i++) {
+            if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) size = strtoull(argv[++i], NULL, 0);
+            else files[file_count++] = argv[i];
+        }
+        int status = record(argv[2], size, files, file_count);
+        free(files);
+        return status;
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "replay") == 0) {
+        int json = (strcmp(argv[2], "--json") == 0);
+        return replay_all(json, argv + 2 + json, argc - 2 - json);
+    }
+
+    fprintf(stderr, "usage: %s record TRACE [--size BYTES] [file ...]\n"
+                    "       %s replay [--json] TRACE ...\n", argv[0], argv[0]);
+    return 2;
+}
@@ -0,0 +1,311 @@
+/*
+ * Conformance and throughput matrix of every LZW compressor in the repository:
+ *   benchmark [--json] [--pmu] [--max-size BYTES] [--engine NAME] [--corpus NAME] [file ...]
+ *
+ * Each engine compresses every generated corpus (text, logs, binary, random, runs) at every size from
+ * 1 B to 64 MB (up to --max-size), plus the files given on the command line. One row per run gives the
+ * ratio, the host MB/s, the busy cycles of the HLS cycle models, and whether the output is bit-exact
+ * against the reference stream: the HLS hash core on the same input, or on the same chunks for the
+ * engines that split their input. Engines with a software decoder add a decompress row, where bit_exact
+ * tells whether the decoded bytes are the input.
+ *
+ * With --pmu every row also gives the hardware counters of the run (pmu.c) per input byte: cycles,
+ * instructions, L1 data and last-level cache misses and mispredicted branches. For the HLS engines they
+ * profile the C-simulation, not the core.
+ *
+ * Build from the repository root (ap_int.h comes with Vitis HLS):
+ *   gcc -O2 -c "HLS_src_codes/ZedBoard/HASH Version/functions.c" -o hls_hash.o
+ *   g++ -O2 -I$XILINX_HLS/include -c "HLS_src_codes/ZedBoard/Parallel Compression Same IP Core/functions.cpp" -o hls_parallel.o
+ *   g++ -O2 -I$XILINX_HLS/include -c "HLS_src_codes/ZedBoard/Interleaved Compression Version/functions.cpp" -o hls_interleaved.o
+ *   gcc -O2 -DLZW_HOSTED -IUser_level_application/Common -c Sw_Src_Codes/Compression/functions.c -o sw_reference.o
+ *   gcc -O2 -DLZW_HOSTED -c User_level_application/Common/lzw_compress_sw.c -o user_sw.o
+ *   g++ -O2 -I$XILINX_HLS/include -c Benchmark_Src_Codes/engine_hls_parallel.cpp Benchmark_Src_Codes/engine_hls_interleaved.cpp
+ *   gcc -O2 -DLZW_HOSTED -c Benchmark_Src_Codes/main.c Benchmark_Src_Codes/corpus.c Benchmark_Src_Codes/engine_hls_hash.c Benchmark_Src_Codes/engine_sw.c Benchmark_Src_Codes/pmu.c
+ * The decoder shares its global names with the Sw_Src_Codes compressor, so it goes in an object that only
+ * exports sw_decoder_decompress:
+ *   gcc -O2 -DLZW_HOSTED -IUser_level_application/Common -c Sw_Src_Codes/Decompression/function.c -o sw_decoder_function.tmp
+ *   gcc -O2 -DLZW_HOSTED -c Benchmark_Src_Codes/engine_sw_decoder.c -o sw_decoder_engine.tmp
+ *   ld -r sw_decoder_function.tmp sw_decoder_engine.tmp -o sw_decoder.o && objcopy -G sw_decoder_decompress sw_decoder.o
+ *   g++ *.o -lm -o benchmark
+ */
+#include "engines.h"
+#include "corpus.h"
+#include "pmu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MIN_SECONDS 0.05              // Small inputs are repeated until a run lasts this long
+#define BENCH_SEED 2024
+
+static const Engine *const engines[] = {&engine_hls_hash, &engine_hls_parallel, &engine_hls_interleaved,
+                                        &engine_sw_reference, &engine_user_sw};
+#define ENGINE_COUNT (sizeof(engines) / sizeof(engines[0]))
+
+static const size_t sizes[] = {1, 16, 256, 4096, 65536, 1 << 20, 16 << 20, 64 << 20};
+#define SIZE_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+
+typedef struct {
+    int json;
+    size_t max_size;
+    const char *engine;         // Only this engine, NULL for all
+    const char *corpus;         // Only this corpus, NULL for all
+    Pmu *pmu;                   // Counters read around every run, NULL without --pmu
+    int rows;
+    int compressions;           // Compress rows that ran
+    int skipped;                // Compress rows skipped, input above the engine's max_input
+    int decompressions;         // Decompress rows
+    int roundtrip_failures;     // Decompress rows whose output is not the input
+} Options;
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Helper functions
+ */
+// -------------------------------------------------------------------------------------
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Reference stream for an engine: the hash core on each of its chunks, back to back.
+ *
+ * @return Reference size in bytes.
+ */
+static size_t reference_stream(const uint8_t *input, size_t size, uint32_t chunks, uint8_t *reference)
+{
+    size_t out = 0;
+    uint64_t cycles;
+    for (uint32_t i = 0; i < chunks; i++) {
+        size_t offset, length;
+        Engine_chunk(size, chunks, i, &offset, &length);
+        out += engine_hls_hash.compress(input + offset, length, reference + out, &cycles);
+    }
+    return out;
+}
+
+/**
+ * @brief Offset of the first byte where a and b differ (the shorter size when one is a prefix of the other).
+ *
+ * @return The offset, -1 when they are the same.
+ */
+static long first_difference(const uint8_t *a, size_t a_size, const uint8_t *b, size_t b_size)
+{
+    size_t common = a_size < b_size ? a_size : b_size;
+    for (size_t i = 0; i < common; i++) {
+        if (a[i] != b[i]) return (long)i;
+    }
+    return (a_size != b_size) ? (long)common : -1;
+}
+
+/**
+ * @brief Prints one row.
+ *
+ * @param counts    Hardware counters of the run, NULL when it did not run.
+ * @param bytes     Input bytes the counters cover (size times the repetitions).
+ */
+static void print_row(Options *options, const char *engine, const char *phase, const char *corpus, size_t size,
+                      size_t compressed, double mb_per_s, uint64_t model_cycles, const char *bit_exact,
+                      long first_diff, const PmuCounts *counts, double bytes)
+{
+    double ratio = size ? 100.0 * compressed / size : 0.0;
+
+    if (options->json) {
+        printf("%s  {\"engine\": \"%s\", \"phase\": \"%s\", \"corpus\": \"%s\", \"size\": %zu, \"compressed\": %zu, "
+               "\"ratio\": %.2f, \"mb_per_s\": %.3f, \"model_cycles\": %llu, \"bit_exact\": \"%s\", \"first_diff\": %ld",
+               options->rows ? ",\n" : "", engine, phase, corpus, size, compressed, ratio, mb_per_s,
+               (unsigned long long)model_cycles, bit_exact, first_diff);
+    } else {
+        printf("%s,%s,%s,%zu,%zu,%.2f,%.3f,%llu,%s,%ld", engine, phase, corpus, size, compressed, ratio, mb_per_s,
+               (unsigned long long)model_cycles, bit_exact, first_diff);
+    }
+
+    for (int e = 0; options->pmu && e < PMU_COUNT; e++) {
+        int valid = counts && counts->valid[e] && bytes > 0;
+        if (options->json && valid) printf(", \"%s_per_byte\": %.4f", Pmu_name((PmuEvent)e), counts->values[e] / bytes);
+        else if (options->json) printf(", \"%s_per_byte\": null", Pmu_name((PmuEvent)e));
+        else if (valid) printf(",%.4f", counts->values[e] / bytes);
+        else printf(",");
+    }
+
+    printf(options->json ? "}" : "\n");
+    options->rows++;
+    fflush(stdout);
+}
+
+/**
+ * @brief Runs every selected engine on one input and prints a row per engine.
+ *
+ * @return Number of runs that are not bit-exact.
+ */
+static int run_input(Options *options, const char *corpus, const uint8_t *input, size_t size)
+{
+    size_t capacity = ENGINE_OUTPUT_BOUND(size, 64);
+    uint8_t *output = malloc(capacity);
+    uint8_t *reference = malloc(capacity);
+    uint8_t *decoded = malloc(size + 16);
+    uint32_t reference_chunks = 0;
+    size_t reference_size = 0;
+    int mismatches = 0;
+
+    for (size_t e = 0; e < ENGINE_COUNT; e++) {
+        const Engine *engine = engines[e];
+        if (options->engine && strcmp(options->engine, engine->name) != 0) continue;
+        if (engine->max_input && size > engine->max_input) {
+            print_row(options, engine->name, "compress", corpus, size, 0, 0.0, 0, "skipped", -1, NULL, 0);
+            options->skipped++;
+            continue;
+        }
+
+        if (reference_chunks != engine->chunks) {
+            reference_size = reference_stream(input, size, engine->chunks, reference);
+            reference_chunks = engine->chunks;
+        }
+
+        uint64_t model_cycles = 0;
+        size_t compressed = 0;
+        int runs = 0;
+        PmuCounts counts;
+        if (options->pmu) Pmu_start(options->pmu);
+        double start = now_seconds(), elapsed;
+        do {
+            compressed = engine->compress(input, size, output, &model_cycles);
+            runs++;
+            elapsed = now_seconds() - start;
+        } while (elapsed < BENCH_MIN_SECONDS);
+        if (options->pmu) Pmu_stop(options->pmu, &counts);
+
+        long first_diff = first_difference(output, compressed, reference, reference_size);
+        options->compressions++;
+        if (first_diff >= 0) mismatches++;
+
+        double mb_per_s = elapsed > 0 ? (double)size * runs / elapsed / 1e6 : 0.0;
+        print_row(options, engine->name, "compress", corpus, size, compressed, mb_per_s, model_cycles,
+                  first_diff < 0 ? "yes" : "no", first_diff, &counts, (double)size * runs);
+
+        if (engine->decompress == NULL || compressed == 0) continue;
+
+        // Round trip through the decoder of the engine; MB/s and counters are per decoded (input) byte.
+        size_t decoded_size = 0;
+        runs = 0;
+        if (options->pmu) Pmu_start(options->pmu);
+        start = now_seconds();
+        do {
+            decoded_size = engine->decompress(output, compressed, decoded, size + 16);
+            runs++;
+            elapsed = now_seconds() - start;
+        } while (elapsed < BENCH_MIN_SECONDS);
+        if (options->pmu) Pmu_stop(options->pmu, &counts);
+
+        first_diff = first_difference(decoded, decoded_size, input, size);
+        options->decompressions++;
+        if (first_diff >= 0) options->roundtrip_failures++;
+
+        mb_per_s = elapsed > 0 ? (double)size * runs / elapsed / 1e6 : 0.0;
+        print_row(options, engine->name, "decompress", corpus, size, compressed, mb_per_s, 0,
+                  first_diff < 0 ? "yes" : "no", first_diff, &counts, (double)size * runs);
+    }
+
+    free(output);
+    free(reference);
+    free(decoded);
+    return mismatches;
+}
+
+static int run_file(Options *options, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    size_t size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t *input = malloc(size + 1);
+    if (fread(input, 1, size, file) != size) size = 0;
+    fclose(file);
+
+    const char *name = strrchr(path, '/');
+    int mismatches = run_input(options, name ? name + 1 : path, input, size);
+    free(input);
+    return mismatches;
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                        Main
+ */
+// -------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    Options options = {0, 64 << 20, NULL, NULL, NULL, 0, 0, 0, 0, 0};
+    Pmu pmu;
+    const char **paths = malloc(argc * sizeof(char *));
+    int path_count = 0, mismatches = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            options.json = 1;
+        } else if (strcmp(argv[i], "--pmu") == 0) {
+            options.pmu = &pmu;
+        } else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            options.max_size = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            options.engine = argv[++i];
+        } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            options.corpus = argv[++i];
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [--json] [--pmu] [--max-size BYTES] [--engine NAME] [--corpus NAME] [file ...]\n",
+                    argv[0]);
+            return 2;
+        } else {
+            paths[path_count++] = argv[i];
+        }
+    }
+
+    if (options.pmu && Pmu_open(options.pmu) == 0) {
+        fprintf(stderr, "No hardware counters (perf_event_open failed, see /proc/sys/kernel/perf_event_paranoid)\n");
+    }
+
+    if (options.json) {
+        printf("[\n");
+    } else {
+        printf("engine,phase,corpus,size,compressed,ratio,mb_per_s,model_cycles,bit_exact,first_diff");
+        for (int e = 0; options.pmu && e < PMU_COUNT; e++) printf(",%s_per_byte", Pmu_name((PmuEvent)e));
+        printf("\n");
+    }
+
+    // With files on the command line the generated corpora only run when --corpus asks for one.
+    if (path_count == 0 || options.corpus) {
+        uint8_t *input = malloc(options.max_size ? options.max_size : 1);
+        for (int kind = 0; kind < CORPUS_COUNT; kind++) {
+            if (options.corpus && strcmp(options.corpus, Corpus_name(kind)) != 0) continue;
+            for (size_t s = 0; s < SIZE_COUNT && sizes[s] <= options.max_size; s++) {
+                Corpus_generate(kind, input, sizes[s], BENCH_SEED + kind);
+                mismatches += run_input(&options, Corpus_name(kind), input, sizes[s]);
+            }
+        }
+        free(input);
+    }
+
+    for (int i = 0; i < path_count; i++) mismatches += run_file(&options, paths[i]);
+    free(paths);
+
+    if (options.json) printf("\n]\n");
+    if (options.pmu) Pmu_close(options.pmu);
+    fprintf(stderr, "%d of %d runs not bit-exact with the hash core, %d runs skipped\n", mismatches, options.compressions,
+            options.skipped);
+    if (options.decompressions) {
+        fprintf(stderr, "%d of %d decompressions did not give the input back\n", options.roundtrip_failures,
+                options.decompressions);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "pmu.h"
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static const char *const names[PMU_COUNT] = {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+
+/* Value, time enabled and time running (PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING) */
+typedef struct {
+    uint64_t value;
+    uint64_t enabled;
+    uint64_t running;
+} PmuReading;
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Helper functions
+ */
+// -------------------------------------------------------------------------------------
+
+static void event_attr(PmuEvent event, struct perf_event_attr *attr)
+{
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->disabled = 1;
+    attr->exclude_kernel = 1;
+    attr->exclude_hv = 1;
+    attr->read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (event) {
+    case PMU_CYCLES:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PMU_INSTRUCTIONS:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PMU_L1D_MISSES:
+        attr->type = PERF_TYPE_HW_CACHE;
+        attr->config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PMU_LLC_MISSES:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    default:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// -------------------------------------------------------------------------------------
+
+int Pmu_open(Pmu *pmu)
+{
+    int opened = 0;
+
+    for (int e = 0; e < PMU_COUNT; e++) {
+        struct perf_event_attr attr;
+        event_attr((PmuEvent)e, &attr);
+        pmu->fds[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (pmu->fds[e] >= 0) opened++;
+    }
+    return opened;
+}
+
+void Pmu_close(Pmu *pmu)
+{
+    for (int e = 0; e < PMU_COUNT; e++) {
+        if (pmu->fds[e] >= 0) close(pmu->fds[e]);
+        pmu->fds[e] = -1;
+    }
+}
+
+void Pmu_start(Pmu *pmu)
+{
+    for (int e = 0; e < PMU_COUNT; e++) {
+        if (pmu->fds[e] < 0) continue;
+        ioctl(pmu->fds[e], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pmu->fds[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void Pmu_stop(Pmu *pmu, PmuCounts *counts)
+{
+    for (int e = 0; e < PMU_COUNT; e++) {
+        if (pmu->fds[e] >= 0) ioctl(pmu->fds[e], PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (int e = 0; e < PMU_COUNT; e++) {
+        PmuReading reading;
+        counts->values[e] = 0;
+        counts->valid[e] = 0;
+        if (pmu->fds[e] < 0 || read(pmu->fds[e], &reading, sizeof(reading)) != sizeof(reading)) continue;
+        if (reading.running == 0) continue;
+
+        // Counted only part of the time when more events were open than the PMU has counters.
+        counts->values[e] = (reading.running < reading.enabled)
+                                ? (uint64_t)((double)reading.value * reading.enabled / reading.running)
+                                : reading.value;
+        counts->valid[e] = 1;
+    }
+}
+
+const char *Pmu_name(PmuEvent event)
+{
+    return (event < PMU_COUNT) ? names[event] : "unknown";
+}
@@ -0,0 +1,63 @@
+#ifndef PMU_H
+#define PMU_H
+
+#include <stdint.h>
+
+/*
+ * Hardware performance counters of the calling thread (Linux perf_event_open), user space only. Each
+ * event is a separate counter, so the ones the CPU or the kernel refuses (e.g. in a VM, or with
+ * perf_event_paranoid > 2) are simply missing from the results; values are scaled when the kernel had to
+ * multiplex the counters.
+ */
+typedef enum {
+    PMU_CYCLES,
+    PMU_INSTRUCTIONS,
+    PMU_L1D_MISSES,             // L1 data cache read misses
+    PMU_LLC_MISSES,             // Last-level cache misses
+    PMU_BRANCH_MISSES,          // Mispredicted branches
+    PMU_COUNT
+} PmuEvent;
+
+typedef struct {
+    int fds[PMU_COUNT];         // -1 for the events that could not be opened
+} Pmu;
+
+typedef struct {
+    uint64_t values[PMU_COUNT];
+    int valid[PMU_COUNT];       // Zero when the event is not counted
+} PmuCounts;
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// ------------------------------------------------------------------------------------
+
+/**
+ * @brief Opens the counters, disabled.
+ *
+ * @return Number of events opened, 0 when there are no hardware counters.
+ */
+int Pmu_open(Pmu *pmu);
+
+/**
+ * @brief Closes the counters.
+ */
+void Pmu_close(Pmu *pmu);
+
+/**
+ * @brief Zeroes and enables the counters.
+ */
+void Pmu_start(Pmu *pmu);
+
+/**
+ * @brief Disables the counters and reads them.
+ */
+void Pmu_stop(Pmu *pmu, PmuCounts *counts);
+
+/**
+ * @brief Name of an event, as printed in the results.
+ */
+const char *Pmu_name(PmuEvent event);
+
+#endif
@@ -0,0 +1,281 @@
+/*
+ * Engine-count and chunk-size scaling of the Multiple IPs orchestration:
+ *   scaling [--json] [--size BYTES] [--corpus NAME] [--cores N] [--trace CSV] [--trace-bin FILE] [file]
+ *
+ * The input (a generated corpus, logs by default, or a file) is cut in chunks and compressed by
+ * Orchestrator_run on a pool of simulated cores (core_sim.h), for every core count from 1 to 32 and
+ * every chunk size from 4 KB to 4 MB, plus the splits of the applications: one chunk per core of equal
+ * bytes (per_core), or balanced on predicted time and cache-line aligned by Partition_split (balanced).
+ * One row per run gives:
+ *   ratio            compressed / input, in %
+ *   ratio_loss       extra compressed bytes against one core on the whole input, in %: the cost of
+ *                    restarting the dictionary at every chunk boundary
+ *   wall_mb_per_s    host throughput of the run, limited by the host CPUs
+ *   sim_mb_per_s     input / busiest core, the throughput of the pool of hash cores: the busy time of a
+ *                    chunk is the cycle count of the core model at SIM_CORE_CLOCK_HZ
+ *   cpu_mb_per_s     input / busiest core in host CPU time of lzw_compress_sw_r, the same pool run in
+ *                    software on one CPU per core (secondary, for comparison with the host)
+ *   speedup          total busy time / busiest core, the useful parallelism of the pool
+ *   chunk_imbalance  max / mean chunk time
+ *   core_imbalance   max / mean busy time per core
+ *
+ * --trace writes the timeline of the balanced run on the most cores (trace.h) as CSV, --trace-bin as the
+ * binary dump (TraceFileHeader, then the TraceEvent array); trace_gantt.py reads either.
+ *
+ * Build from the repository root:
+ *   gcc -O2 -pthread -DLZW_HOSTED -IUser_level_application/Common Benchmark_Src_Codes/scaling.c \
+ *       Benchmark_Src_Codes/core_sim.c Benchmark_Src_Codes/corpus.c User_level_application/Common/orchestrator.c \
+ *       User_level_application/Common/partition.c User_level_application/Common/trace.c \
+ *       User_level_application/Common/lzw_compress_sw.c Benchmark_Src_Codes/engine_hls_hash.c \
+ *       "HLS_src_codes/ZedBoard/HASH Version/functions.c" -o scaling
+ */
+#include "core_sim.h"
+#include "corpus.h"
+#include "partition.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SCALING_SEED 2024
+
+static const uint32_t core_counts[] = {1, 2, 4, 8, 10, 12, 16, 24, 32};
+#define CORE_COUNT_COUNT (sizeof(core_counts) / sizeof(core_counts[0]))
+
+static const uint32_t chunk_sizes[] = {4 << 10, 16 << 10, 64 << 10, 256 << 10, 1 << 20, 4 << 20};
+#define CHUNK_SIZE_COUNT (sizeof(chunk_sizes) / sizeof(chunk_sizes[0]))
+
+#define SCALING_MAX_CORES 32
+
+typedef struct {
+    int json;
+    int rows;
+} Options;
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Helper functions
+ */
+// -------------------------------------------------------------------------------------
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void print_row(Options *options, uint32_t cores, const char *split, uint32_t chunk_size, uint32_t chunks,
+                      double ratio, double ratio_loss, double wall_mb_per_s, double sim_mb_per_s, double cpu_mb_per_s,
+                      double speedup, double chunk_imbalance, double core_imbalance)
+{
+    if (options->json) {
+        printf("%s  {\"cores\": %u, \"split\": \"%s\", \"chunk_size\": %u, \"chunks\": %u, \"ratio\": %.2f, "
+               "\"ratio_loss\": %.3f, \"wall_mb_per_s\": %.3f, \"sim_mb_per_s\": %.3f, \"cpu_mb_per_s\": %.3f, "
+               "\"speedup\": %.2f, \"chunk_imbalance\": %.3f, \"core_imbalance\": %.3f}",
+               options->rows ? ",\n" : "", cores, split, chunk_size, chunks, ratio, ratio_loss, wall_mb_per_s,
+               sim_mb_per_s, cpu_mb_per_s, speedup, chunk_imbalance, core_imbalance);
+    } else {
+        printf("%u,%s,%u,%u,%.2f,%.3f,%.3f,%.3f,%.3f,%.2f,%.3f,%.3f\n", cores, split, chunk_size, chunks, ratio,
+               ratio_loss, wall_mb_per_s, sim_mb_per_s, cpu_mb_per_s, speedup, chunk_imbalance, core_imbalance);
+    }
+    options->rows++;
+    fflush(stdout);
+}
+
+/**
+ * @brief Compresses the input in chunk_count chunks on a pool of simulated cores and prints the row.
+ */
+static void run_config(Options *options, SimCore *pool, uint32_t cores, const char *split,
+                       const PartitionOptions *partition, const uint8_t *input, uint32_t size, uint32_t chunk_count,
+                       uint8_t *output, uint64_t whole_size, Trace *trace)
+{
+    LzwChunk *chunks = malloc(chunk_count * sizeof(LzwChunk));
+    uint32_t *offsets = malloc(chunk_count * sizeof(uint32_t));
+    uint32_t *sizes = malloc(chunk_count * sizeof(uint32_t));
+    void *handles[SCALING_MAX_CORES];
+    double core_busy[SCALING_MAX_CORES] = {0};
+    double core_cpu[SCALING_MAX_CORES] = {0};
+
+    Partition_split(input, size, chunk_count, partition, offsets, sizes);
+    Orchestrator_split(input, offsets, sizes, chunks, chunk_count);
+    // Each chunk writes at twice its input offset: the regions never overlap.
+    for (uint32_t i = 0; i < chunk_count; i++) chunks[i].output = output + 2 * (size_t)(chunks[i].input - input);
+    for (uint32_t c = 0; c < cores; c++) {
+        handles[c] = &pool[c];
+        core_cpu[c] = -pool[c].cpu_seconds;
+    }
+
+    double start = now_seconds();
+    if (trace) Trace_init(trace);
+    uint64_t compressed = Orchestrator_run(&sim_core_ops, handles, cores, chunks, chunk_count, trace);
+    double wall = now_seconds() - start;
+
+    double total_busy = 0, max_chunk = 0;
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        core_busy[chunks[i].core] += chunks[i].busy_seconds;
+        total_busy += chunks[i].busy_seconds;
+        if (chunks[i].busy_seconds > max_chunk) max_chunk = chunks[i].busy_seconds;
+    }
+    double max_core = 0, max_cpu = 0;
+    for (uint32_t c = 0; c < cores; c++) {
+        core_cpu[c] += pool[c].cpu_seconds;
+        if (core_busy[c] > max_core) max_core = core_busy[c];
+        if (core_cpu[c] > max_cpu) max_cpu = core_cpu[c];
+    }
+
+    double mean_chunk = total_busy / chunk_count;
+    double mean_core = total_busy / cores;
+    print_row(options, cores, split, (size + chunk_count - 1) / chunk_count, chunk_count,
+              100.0 * compressed / size, 100.0 * ((double)compressed - whole_size) / whole_size,
+              wall > 0 ? size / wall / 1e6 : 0.0, max_core > 0 ? size / max_core / 1e6 : 0.0,
+              max_cpu > 0 ? size / max_cpu / 1e6 : 0.0, max_core > 0 ? total_busy / max_core : 0.0, mean_chunk > 0 ? max_chunk / mean_chunk : 0.0,
+              mean_core > 0 ? max_core / mean_core : 0.0);
+    free(chunks);
+    free(offsets);
+    free(sizes);
+}
+
+static uint8_t *read_file(const char *path, uint32_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = (uint32_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t *input = malloc(*size + 1);
+    if (fread(input, 1, *size, file) != *size) *size = 0;
+    fclose(file);
+    return input;
+}
+
+static void write_trace(const Trace *trace, const char *csv_path, const char *bin_path)
+{
+    if (csv_path) {
+        size_t capacity = 64 * (TRACE_MAX_EVENTS + 1);
+        char *csv = malloc(capacity);
+        FILE *file = fopen(csv_path, "w");
+        if (file == NULL) {
+            fprintf(stderr, "Cannot open %s\n", csv_path);
+        } else {
+            fwrite(csv, 1, Trace_format_csv(trace, csv, capacity), file);
+            fclose(file);
+        }
+        free(csv);
+    }
+
+    if (bin_path) {
+        TraceFileHeader header;
+        Trace_file_header(trace, &header);
+        FILE *file = fopen(bin_path, "wb");
+        if (file == NULL) {
+            fprintf(stderr, "Cannot open %s\n", bin_path);
+        } else {
+            fwrite(&header, sizeof(header), 1, file);
+            fwrite(trace->events, sizeof(TraceEvent), trace->count, file);
+            fclose(file);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                        Main
+ */
+// -------------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    Options options = {0, 0};
+    uint32_t size = 16 << 20, max_cores = SCALING_MAX_CORES;
+    const PartitionOptions balanced = {64, 0, -1, 1};
+    const char *corpus = "logs", *path = NULL, *trace_path = NULL, *trace_bin_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            options.json = 1;
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            size = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            corpus = argv[++i];
+        } else if (strcmp(argv[i], "--cores") == 0 && i + 1 < argc) {
+            max_cores = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace-bin") == 0 && i + 1 < argc) {
+            trace_bin_path = argv[++i];
+        } else if (argv[i][0] == '-' || path != NULL) {
+            fprintf(stderr, "usage: %s [--json] [--size BYTES] [--corpus NAME] [--cores N] [--trace CSV] [--trace-bin FILE] [file]\n", argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (max_cores > SCALING_MAX_CORES) max_cores = SCALING_MAX_CORES;
+
+    uint8_t *input;
+    if (path) {
+        input = read_file(path, &size);
+        if (input == NULL) {
+            fprintf(stderr, "Cannot open %s\n", path);
+            return 1;
+        }
+    } else {
+        int kind = 0;
+        while (kind < CORPUS_COUNT && strcmp(corpus, Corpus_name(kind)) != 0) kind++;
+        if (kind == CORPUS_COUNT) {
+            fprintf(stderr, "Unknown corpus %s\n", corpus);
+            return 2;
+        }
+        input = malloc(size ? size : 1);
+        Corpus_generate(kind, input, size, SCALING_SEED + kind);
+    }
+    if (size == 0) {
+        fprintf(stderr, "Empty input\n");
+        return 1;
+    }
+
+    uint8_t *output = malloc(2 * (size_t)size + 16);
+    SimCore *pool = malloc(SCALING_MAX_CORES * sizeof(SimCore));
+    for (uint32_t c = 0; c < max_cores; c++) {
+        if (SimCore_create(&pool[c]) != 0) {
+            fprintf(stderr, "Cannot start simulated core %u\n", c);
+            return 1;
+        }
+    }
+
+    // One core on the whole input: the ratio every split is measured against.
+    uint32_t whole_size = 0;
+    lzw_compress_sw(input, output, (int)size, &whole_size);
+    fprintf(stderr, "%s: %u bytes, %u compressed as one chunk\n", path ? path : corpus, size, whole_size);
+
+    Trace *trace = (trace_path || trace_bin_path) ? malloc(sizeof(Trace)) : NULL;
+
+    if (options.json) printf("[\n");
+    else printf("cores,split,chunk_size,chunks,ratio,ratio_loss,wall_mb_per_s,sim_mb_per_s,cpu_mb_per_s,speedup,chunk_imbalance,core_imbalance\n");
+
+    for (size_t n = 0; n < CORE_COUNT_COUNT && core_counts[n] <= max_cores; n++) {
+        uint32_t cores = core_counts[n];
+        // The splits of the parallel applications: one chunk per core.
+        uint32_t per_core = cores < size ? cores : size;
+        run_config(&options, pool, cores, "per_core", NULL, input, size, per_core, output, whole_size, NULL);
+        run_config(&options, pool, cores, "balanced", &balanced, input, size, per_core, output, whole_size, trace);
+        for (size_t s = 0; s < CHUNK_SIZE_COUNT; s++) {
+            uint32_t chunk_count = (size + chunk_sizes[s] - 1) / chunk_sizes[s];
+            run_config(&options, pool, cores, "fixed", NULL, input, size, chunk_count, output, whole_size, NULL);
+        }
+    }
+
+    if (options.json) printf("\n]\n");
+
+    if (trace) {
+        write_trace(trace, trace_path, trace_bin_path);
+        free(trace);
+    }
+    for (uint32_t c = 0; c < max_cores; c++) SimCore_destroy(&pool[c]);
+    free(pool);
+    free(output);
+    free(input);
+    return 0;
+}
@@ -1,153 +1,1028 @@
 #include "functions.h"
 
 /**************************  Global Variables Declarations ******************************/
+// Each slot of the table has an epoch tag in dictionary_tag, see Dictionary_load.
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+static Dictionary dictionary[DICTIONARY_BUCKET_COUNT][DICTIONARY_BUCKET_WAYS];
+static uint8_t dictionary_tag[DICTIONARY_BUCKET_COUNT][DICTIONARY_BUCKET_WAYS];
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+static Dictionary dictionary[2][DICTIONARY_CUCKOO_SIZE];
+static uint8_t dictionary_tag[2][DICTIONARY_CUCKOO_SIZE];
+static Dictionary dictionary_stash[DICTIONARY_STASH_SIZE];
+#else
 static Dictionary dictionary[MAX_DICTIONARY_SIZE];
-static bool dictionary_used[MAX_DICTIONARY_SIZE];
+static uint8_t dictionary_tag[MAX_DICTIONARY_SIZE];
+#endif
+
+// Epoch of the current dictionary. It starts on the last one, so the first job wraps it and clears
+// the table, whatever the BRAM held before.
+static uint8_t dictionary_epoch = DICTIONARY_EPOCH_MASK;
+
+#if LZW_SPECULATIVE
+// Copy of the table for the speculative second lookup (every write goes to both), and
+// the last string seen after each prefix code, used to guess the code of the first lookup.
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+static Dictionary dictionary_shadow[DICTIONARY_BUCKET_COUNT][DICTIONARY_BUCKET_WAYS];
+static uint8_t dictionary_shadow_tag[DICTIONARY_BUCKET_COUNT][DICTIONARY_BUCKET_WAYS];
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+static Dictionary dictionary_shadow[2][DICTIONARY_CUCKOO_SIZE];
+static uint8_t dictionary_shadow_tag[2][DICTIONARY_CUCKOO_SIZE];
+#else
+static Dictionary dictionary_shadow[MAX_DICTIONARY_SIZE];
+static uint8_t dictionary_shadow_tag[MAX_DICTIONARY_SIZE];
+#endif
+static Dictionary dictionary_successor[MAX_DICTIONARY_SIZE];
+#endif
+
+#if DICTIONARY_CACHE_SIZE > 0
+static Dictionary dictionary_cache[DICTIONARY_CACHE_SIZE];
+static uint8_t dictionary_cache_next = 0;
+#endif
+
+#ifndef __SYNTHESIS__
+static uint32_t dictionary_cache_lookups = 0;
+static uint32_t dictionary_cache_hits = 0;
+#endif
+
+// Last DICTIONARY_FORWARD_DEPTH entries written by the main loop, newest first, see Dictionary_load
+static uint32_t dictionary_forward_addr[DICTIONARY_FORWARD_DEPTH];
+static Dictionary dictionary_forward_entry[DICTIONARY_FORWARD_DEPTH];
+
+#if DICTIONARY_HAZARD_CHECK && !defined(__SYNTHESIS__)
+// Table writes not landed yet, in issue order (a clear row writes up to DICTIONARY_BUCKET_WAYS slots per iteration).
+#define DICTIONARY_HAZARD_QUEUE     256
+static struct {
+    uint32_t addr;
+    Dictionary entry;
+    uint8_t tag;
+    uint32_t iteration;
+} dictionary_hazard[DICTIONARY_HAZARD_QUEUE];
+static uint32_t dictionary_hazard_head = 0;
+static uint32_t dictionary_hazard_tail = 0;
+static uint32_t dictionary_hazard_iteration = 0;
+#endif
+
+static uint32_t lzw_perf[LZW_PERF_COUNT];
+
+static uint32_t lz4_table[1u << LZ4_HASH_BITS];
+static uint8_t lz4_window[LZ4_WINDOW_SIZE];
+
+#if LZW_PERF_COUNTERS
+#define LZW_PERF_ADD(counter, n)    (lzw_perf[(counter)] += (n))
+#else
+#define LZW_PERF_ADD(counter, n)    ((void)0)
+#endif
 
 /**************************  Helper Functions Declarations ******************************/
-void init_dictionary(void){
-    #pragma HLS INLINE off
-    memset(dictionary_used, 0, sizeof(dictionary_used));
-    for (uint16_t i = 0; i < 256; i++){
-        #pragma HLS PIPELINE II=1
-        dictionary[i].code = i;
-        dictionary[i].prefix_code = INVALID_CODE;
-        dictionary[i].ext_byte = i;
-        dictionary_used[i] = true;
+static void Perf_probes(uint32_t probes){
+    #pragma HLS INLINE
+#if LZW_PERF_COUNTERS
+    lzw_perf[LZW_PERF_PROBES] += probes;
+    if (probes > lzw_perf[LZW_PERF_PROBE_MAX]) lzw_perf[LZW_PERF_PROBE_MAX] = probes;
+#else
+    (void)probes;
+#endif
+}
+
+static void Perf_copy(uint32_t perf_counters[LZW_PERF_COUNT]){
+    #pragma HLS INLINE
+    for (uint32_t i = 0; i < LZW_PERF_COUNT; i++){
+        #pragma HLS UNROLL
+        perf_counters[i] = lzw_perf[i];
+    }
+}
+
+static void Dictionary_cache_invalidate(void){
+    #pragma HLS INLINE
+#if DICTIONARY_CACHE_SIZE > 0
+    for (uint32_t i = 0; i < DICTIONARY_CACHE_SIZE; i++){
+        #pragma HLS UNROLL
+        dictionary_cache[i] = 0;
+    }
+    dictionary_cache_next = 0;
+#endif
+}
+
+Dictionary Dictionary_pack(uint16_t prefix, uint8_t ext, uint16_t code) {
+    #pragma HLS INLINE
+    return ((uint32_t)code << DICTIONARY_CODE_SHIFT) | ((uint32_t)ext << 12) | (prefix & 0xFFF);
+}
+
+uint16_t Dictionary_code(Dictionary entry) {
+    #pragma HLS INLINE
+    return entry >> DICTIONARY_CODE_SHIFT;
+}
+
+static uint32_t bram36_count(uint32_t depth, uint32_t width) {
+    // BRAM36 aspect ratios (depth x width), the narrowest that fits wins.
+    static const uint32_t depths[7] = {32768, 16384, 8192, 4096, 2048, 1024, 512};
+    static const uint32_t widths[7] = {1, 2, 4, 9, 18, 36, 72};
+    uint32_t best = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < 7; i++) {
+        uint32_t count = ((depth + depths[i] - 1) / depths[i]) * ((width + widths[i] - 1) / widths[i]);
+        if (count < best) best = count;
     }
+    return best;
+}
+
+uint32_t Dictionary_bram36(void) {
+    uint32_t width = 8 * sizeof(Dictionary);
+    uint32_t tag_width = 8 * sizeof(dictionary_epoch);
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    return DICTIONARY_BUCKET_WAYS * (bram36_count(DICTIONARY_BUCKET_COUNT, width) + bram36_count(DICTIONARY_BUCKET_COUNT, tag_width));
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    return 2 * (bram36_count(DICTIONARY_CUCKOO_SIZE, width) + bram36_count(DICTIONARY_CUCKOO_SIZE, tag_width));
+#else
+    return bram36_count(MAX_DICTIONARY_SIZE, width) + bram36_count(MAX_DICTIONARY_SIZE, tag_width);
+#endif
 }
 
-void Dictionary_reset(uint16_t *dictionary_size, uint8_t *bit_count) {
-    #pragma HLS INLINE off
-    (*dictionary_size) = 256;
-    (*bit_count) = 8;
-    init_dictionary();
+uint32_t hash_mix(uint16_t prefix, uint8_t ext) {
+    #pragma HLS INLINE
+    uint32_t key = ((uint32_t)ext << 12) | prefix;
+#if LZW_HASH_FUNCTION == LZW_HASH_CRC
+    // 20 bit steps of the reflected CRC register, unrolled into an XOR tree.
+    for (int i = 0; i < 20; i++) {
+        #pragma HLS UNROLL
+        key = (key >> 1) ^ (CRC32_POLY & (0u - (key & 1)));
+    }
+    return key;
+#else
+    return key * 2654435761u;
+#endif
 }
 
 uint32_t hash1(uint16_t prefix, uint8_t ext) {
     #pragma HLS INLINE
+#if LZW_HASH_FUNCTION == LZW_HASH_SHIFT_XOR
     return ((prefix << 8) ^ ext) & (MAX_DICTIONARY_SIZE - 1);
+#else
+    return hash_mix(prefix, ext) >> (32 - MAX_CODE_BITS);
+#endif
 }
 
 uint32_t hash2(uint16_t prefix, uint8_t ext) {
     #pragma HLS INLINE
+#if LZW_HASH_FUNCTION == LZW_HASH_SHIFT_XOR
     return (((prefix << 5) ^ (ext * 7)) & (MAX_DICTIONARY_SIZE - 1)) | 1;
+#else
+    return ((hash_mix(prefix, ext) >> 8) & (MAX_DICTIONARY_SIZE - 1)) | 1;
+#endif
 }
 
-uint16_t Dictionary_find(uint16_t prefix, uint8_t ext) {
-    #pragma HLS INLINE off
-    uint32_t h1 = hash1(prefix, ext);
-    uint32_t h2 = hash2(prefix, ext);
-    for (uint32_t i = 0; i < MAX_DICTIONARY_SIZE; i++) {
-        #pragma HLS PIPELINE II=1
-        uint32_t idx = (h1 + i * h2) & (MAX_DICTIONARY_SIZE - 1);
+uint32_t hash_bucket(uint16_t prefix, uint8_t ext) {
+    #pragma HLS INLINE
+    return hash_mix(prefix, ext) >> (32 - DICTIONARY_BUCKET_BITS);
+}
 
-        if (!dictionary_used[idx]) return INVALID_CODE;
+uint32_t hash_cuckoo0(uint16_t prefix, uint8_t ext) {
+    #pragma HLS INLINE
+    return hash_mix(prefix, ext) >> (32 - DICTIONARY_CUCKOO_BITS);
+}
+
+uint32_t hash_cuckoo1(uint16_t prefix, uint8_t ext) {
+    #pragma HLS INLINE
+    uint32_t key = ((uint32_t)ext << 12) | prefix;
+    return ((key ^ (key >> 7)) * 0x85EBCA6Bu) >> (32 - DICTIONARY_CUCKOO_BITS);
+}
 
-        if (dictionary[idx].prefix_code == prefix && dictionary[idx].ext_byte == ext) return dictionary[idx].code;
+uint16_t Dictionary_cache_find(uint16_t prefix, uint8_t ext) {
+    #pragma HLS INLINE
+    uint16_t code = INVALID_CODE;
+#if DICTIONARY_CACHE_SIZE > 0
+    Dictionary key = Dictionary_pack(prefix, ext, 0);
+    // Every entry is compared in parallel, independently of the hash computation.
+    for (uint32_t i = 0; i < DICTIONARY_CACHE_SIZE; i++) {
+        #pragma HLS UNROLL
+        Dictionary entry = dictionary_cache[i];
+        if (Dictionary_code(entry) != 0 && (entry & DICTIONARY_KEY_MASK) == key) code = Dictionary_code(entry);
     }
-    return INVALID_CODE;
+#else
+    (void)prefix;
+    (void)ext;
+#endif
+    return code;
 }
 
-void Dictionary_add(uint16_t prefix, uint8_t ext, uint16_t *dictionary_size, uint8_t *bit_count) {
-    #pragma HLS INLINE off
-    if (*dictionary_size >= MAX_DICTIONARY_SIZE) Dictionary_reset(dictionary_size, bit_count);
-    if (*dictionary_size >= (1u << *bit_count)) (*bit_count)++;
+void Dictionary_cache_insert(uint16_t prefix, uint8_t ext, uint16_t code) {
+    #pragma HLS INLINE
+#if DICTIONARY_CACHE_SIZE > 0
+    dictionary_cache[dictionary_cache_next] = Dictionary_pack(prefix, ext, code);
+    dictionary_cache_next = (dictionary_cache_next + 1) % DICTIONARY_CACHE_SIZE;
+#else
+    (void)prefix;
+    (void)ext;
+    (void)code;
+#endif
+}
 
-    uint32_t h1 = hash1(prefix, ext);
-    uint32_t h2 = hash2(prefix, ext);
-    for (uint32_t i = 0; i < MAX_DICTIONARY_SIZE; i++) {
-        #pragma HLS PIPELINE II=1
-        uint32_t idx = (h1 + i * h2) & (MAX_DICTIONARY_SIZE - 1);
-
-        if (!dictionary_used[idx]) {
-            dictionary[idx].prefix_code = prefix;
-            dictionary[idx].ext_byte = ext;
-            dictionary[idx].code = *dictionary_size;
-            dictionary_used[idx] = true;
-            (*dictionary_size)++;
-            return;
-        }
+void Dictionary_cache_stats(uint32_t *lookups, uint32_t *hits) {
+#ifndef __SYNTHESIS__
+    *lookups = dictionary_cache_lookups;
+    *hits = dictionary_cache_hits;
+#else
+    *lookups = 0;
+    *hits = 0;
+#endif
+}
+
+/*
+ * Table accesses of the main loop go through Dictionary_load / Dictionary_store with a flat address
+ * (slot, bucket * ways + way, or bank * slots + slot). A slot whose tag is not the current epoch was written
+ * for an earlier dictionary and reads as free. The main loop declares the dictionary free of
+ * dependences below DICTIONARY_FORWARD_DISTANCE iterations, so the last DICTIONARY_FORWARD_DEPTH entries
+ * written are kept in registers and override a load of the same address, before they have reached the BRAM.
+ */
+static Dictionary Dictionary_load(uint32_t addr, bool shadow) {
+    #pragma HLS INLINE
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    Dictionary stored = dictionary[addr / DICTIONARY_BUCKET_WAYS][addr % DICTIONARY_BUCKET_WAYS];
+    uint8_t tag = dictionary_tag[addr / DICTIONARY_BUCKET_WAYS][addr % DICTIONARY_BUCKET_WAYS];
+#if LZW_SPECULATIVE
+    if (shadow) {
+        stored = dictionary_shadow[addr / DICTIONARY_BUCKET_WAYS][addr % DICTIONARY_BUCKET_WAYS];
+        tag = dictionary_shadow_tag[addr / DICTIONARY_BUCKET_WAYS][addr % DICTIONARY_BUCKET_WAYS];
+    }
+#endif
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    Dictionary stored = dictionary[addr / DICTIONARY_CUCKOO_SIZE][addr % DICTIONARY_CUCKOO_SIZE];
+    uint8_t tag = dictionary_tag[addr / DICTIONARY_CUCKOO_SIZE][addr % DICTIONARY_CUCKOO_SIZE];
+#if LZW_SPECULATIVE
+    if (shadow) {
+        stored = dictionary_shadow[addr / DICTIONARY_CUCKOO_SIZE][addr % DICTIONARY_CUCKOO_SIZE];
+        tag = dictionary_shadow_tag[addr / DICTIONARY_CUCKOO_SIZE][addr % DICTIONARY_CUCKOO_SIZE];
+    }
+#endif
+#else
+    Dictionary stored = dictionary[addr];
+    uint8_t tag = dictionary_tag[addr];
+#if LZW_SPECULATIVE
+    if (shadow) {
+        stored = dictionary_shadow[addr];
+        tag = dictionary_shadow_tag[addr];
     }
+#endif
+#endif
+#if !LZW_SPECULATIVE
+    (void)shadow;
+#endif
+    if (tag != dictionary_epoch) stored = 0;
+    // The newest matching store wins.
+    for (int i = DICTIONARY_FORWARD_DEPTH - 1; i >= 0; i--) {
+        #pragma HLS UNROLL
+        if (addr == dictionary_forward_addr[i]) stored = dictionary_forward_entry[i];
+    }
+    return stored;
+}
+
+/* Writes one table slot, and its shadow copy, with an epoch tag. */
+static void Dictionary_commit(uint32_t addr, Dictionary entry, uint8_t tag) {
+    #pragma HLS INLINE
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    dictionary[addr / DICTIONARY_BUCKET_WAYS][addr % DICTIONARY_BUCKET_WAYS] = entry;
+    dictionary_tag[addr / DICTIONARY_BUCKET_WAYS][addr % DICTIONARY_BUCKET_WAYS] = tag;
+#if LZW_SPECULATIVE
+    dictionary_shadow[addr / DICTIONARY_BUCKET_WAYS][addr % DICTIONARY_BUCKET_WAYS] = entry;
+    dictionary_shadow_tag[addr / DICTIONARY_BUCKET_WAYS][addr % DICTIONARY_BUCKET_WAYS] = tag;
+#endif
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    dictionary[addr / DICTIONARY_CUCKOO_SIZE][addr % DICTIONARY_CUCKOO_SIZE] = entry;
+    dictionary_tag[addr / DICTIONARY_CUCKOO_SIZE][addr % DICTIONARY_CUCKOO_SIZE] = tag;
+#if LZW_SPECULATIVE
+    dictionary_shadow[addr / DICTIONARY_CUCKOO_SIZE][addr % DICTIONARY_CUCKOO_SIZE] = entry;
+    dictionary_shadow_tag[addr / DICTIONARY_CUCKOO_SIZE][addr % DICTIONARY_CUCKOO_SIZE] = tag;
+#endif
+#else
+    dictionary[addr] = entry;
+    dictionary_tag[addr] = tag;
+#if LZW_SPECULATIVE
+    dictionary_shadow[addr] = entry;
+    dictionary_shadow_tag[addr] = tag;
+#endif
+#endif
 }
 
-void write_output(uint16_t code, uint8_t *output, uint8_t bit_count, uint32_t *out_index) {
-    #pragma HLS INLINE off
-    uint32_t idx = *out_index;
-    uint32_t byte_index = idx / 8;
-    uint32_t bit_offset = idx % 8;
+static void Dictionary_write(uint32_t addr, Dictionary entry) {
+    #pragma HLS INLINE
+#if DICTIONARY_HAZARD_CHECK && !defined(__SYNTHESIS__)
+    uint32_t i = dictionary_hazard_tail++ % DICTIONARY_HAZARD_QUEUE;
+    dictionary_hazard[i].addr = addr;
+    dictionary_hazard[i].entry = entry;
+    dictionary_hazard[i].tag = dictionary_epoch;
+    dictionary_hazard[i].iteration = dictionary_hazard_iteration;
+#else
+    Dictionary_commit(addr, entry, dictionary_epoch);
+#endif
+}
 
-    uint32_t bits_left = bit_count;
-    while (bits_left > 0) {
-        #pragma HLS PIPELINE II=1
-        uint8_t space_in_byte = 8 - bit_offset;
-        uint8_t bits_to_write = (bits_left < space_in_byte) ? bits_left : space_in_byte;
-        uint8_t mask = ((code >> (bits_left - bits_to_write)) & ((1U << bits_to_write) - 1));
+static void Dictionary_store(uint32_t addr, Dictionary entry) {
+    #pragma HLS INLINE
+    Dictionary_write(addr, entry);
+    for (int i = DICTIONARY_FORWARD_DEPTH - 1; i > 0; i--) {
+        #pragma HLS UNROLL
+        dictionary_forward_addr[i] = dictionary_forward_addr[i - 1];
+        dictionary_forward_entry[i] = dictionary_forward_entry[i - 1];
+    }
+    dictionary_forward_addr[0] = addr;
+    dictionary_forward_entry[0] = entry;
+}
+
+static void Dictionary_forward_reset(void) {
+    #pragma HLS INLINE
+    for (int i = 0; i < DICTIONARY_FORWARD_DEPTH; i++) {
+        #pragma HLS UNROLL
+        dictionary_forward_addr[i] = DICTIONARY_NO_ADDR;
+    }
+}
+
+/* Main loop iteration boundary: lands the writes old enough (C simulation with DICTIONARY_HAZARD_CHECK only). */
+static void Dictionary_hazard_tick(bool flush) {
+    #pragma HLS INLINE
+#if DICTIONARY_HAZARD_CHECK && !defined(__SYNTHESIS__)
+    dictionary_hazard_iteration++;
+    while (dictionary_hazard_head != dictionary_hazard_tail) {
+        uint32_t i = dictionary_hazard_head % DICTIONARY_HAZARD_QUEUE;
+        if (!flush && dictionary_hazard[i].iteration + DICTIONARY_HAZARD_DISTANCE > dictionary_hazard_iteration) break;
+        Dictionary_commit(dictionary_hazard[i].addr, dictionary_hazard[i].entry, dictionary_hazard[i].tag);
+        dictionary_hazard_head++;
+    }
+#else
+    (void)flush;
+#endif
+}
+
+uint32_t Dictionary_first_row(uint16_t prefix, uint8_t ext) {
+    #pragma HLS INLINE
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    return hash_bucket(prefix, ext);
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    return hash_cuckoo0(prefix, ext);
+#else
+    return hash1(prefix, ext);
+#endif
+}
+
+bool Dictionary_new_epoch(void) {
+    #pragma HLS INLINE
+    dictionary_epoch = (dictionary_epoch + 1) & DICTIONARY_EPOCH_MASK;
+    Dictionary_forward_reset();
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    for (uint32_t i = 0; i < DICTIONARY_STASH_SIZE; i++) {
+        #pragma HLS UNROLL
+        dictionary_stash[i] = 0;
+    }
+#endif
+    // Tags of the same epoch may still be in the table, left 2^DICTIONARY_EPOCH_BITS dictionaries ago.
+    return dictionary_epoch == 0;
+}
+
+void Dictionary_clear_row(uint32_t row, uint32_t pending_row, Dictionary pending_entry) {
+    #pragma HLS INLINE
+    // Single-byte codes are implicit: lookups always have a prefix code, so the 256 roots never need a slot.
+    // The entry whose insert triggered the reset goes to its first choice slot, which is free in an empty table.
+    // The rows are not forwarded: LZW_STATE_CLEAR settles DICTIONARY_FORWARD_DEPTH iterations before the first lookup.
+    Dictionary first = (row == pending_row) ? pending_entry : 0;
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    for (uint32_t w = 0; w < DICTIONARY_BUCKET_WAYS; w++) {
+        #pragma HLS UNROLL
+        Dictionary_write(row * DICTIONARY_BUCKET_WAYS + w, (w == 0) ? first : 0);
+    }
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    Dictionary_write(row, first);
+    Dictionary_write(DICTIONARY_CUCKOO_SIZE + row, 0);
+#else
+    Dictionary_write(row, first);
+#endif
+}
+
+uint16_t Dictionary_probe(uint16_t prefix, uint8_t ext, uint32_t probe, uint32_t *slot, bool shadow) {
+    #pragma HLS INLINE
+    Dictionary key = Dictionary_pack(prefix, ext, 0);
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    // All the ways of the bucket are compared at once: the probe always resolves.
+    (void)probe;
+    uint32_t bucket = hash_bucket(prefix, ext);
+    uint16_t code = INVALID_CODE;
+    for (uint32_t w = 0; w < DICTIONARY_BUCKET_WAYS; w++) {
+        #pragma HLS UNROLL
+        Dictionary entry = Dictionary_load(bucket * DICTIONARY_BUCKET_WAYS + w, shadow);
+        if (Dictionary_code(entry) != 0 && (entry & DICTIONARY_KEY_MASK) == key) code = Dictionary_code(entry);
+    }
+    *slot = bucket;
+    return code;
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    // Both banks and the whole stash are read in the same cycle: the probe always resolves.
+    (void)probe;
+    uint32_t s0 = hash_cuckoo0(prefix, ext);
+    uint32_t s1 = hash_cuckoo1(prefix, ext);
+    Dictionary e0 = Dictionary_load(s0, shadow);
+    Dictionary e1 = Dictionary_load(DICTIONARY_CUCKOO_SIZE + s1, shadow);
+    uint16_t code = INVALID_CODE;
+    if (Dictionary_code(e0) != 0 && (e0 & DICTIONARY_KEY_MASK) == key) code = Dictionary_code(e0);
+    if (Dictionary_code(e1) != 0 && (e1 & DICTIONARY_KEY_MASK) == key) code = Dictionary_code(e1);
+    for (uint32_t i = 0; i < DICTIONARY_STASH_SIZE; i++) {
+        #pragma HLS UNROLL
+        Dictionary entry = dictionary_stash[i];
+        if (Dictionary_code(entry) != 0 && (entry & DICTIONARY_KEY_MASK) == key) code = Dictionary_code(entry);
+    }
+    *slot = s0;
+    return code;
+#else
+    uint32_t idx = (hash1(prefix, ext) + probe * hash2(prefix, ext)) & (MAX_DICTIONARY_SIZE - 1);
+    Dictionary entry = Dictionary_load(idx, shadow);
+    *slot = idx;
+    if (Dictionary_code(entry) == 0) return INVALID_CODE;
+    if ((entry & DICTIONARY_KEY_MASK) == key) return Dictionary_code(entry);
+    return DICTIONARY_PROBE_AGAIN;
+#endif
+}
+
+bool Dictionary_insert(Dictionary entry, uint32_t slot) {
+    #pragma HLS INLINE
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    // The code is consumed even when the bucket is full: the decoder allocates it regardless,
+    // the encoder simply never matches that string.
+    bool placed = false;
+    uint32_t addr = DICTIONARY_NO_ADDR;
+    for (uint32_t w = 0; w < DICTIONARY_BUCKET_WAYS; w++) {
+        #pragma HLS UNROLL
+        if (!placed && Dictionary_code(Dictionary_load(slot * DICTIONARY_BUCKET_WAYS + w, false)) == 0) {
+            addr = slot * DICTIONARY_BUCKET_WAYS + w;
+            placed = true;
+        }
+    }
+    if (placed) Dictionary_store(addr, entry);
+    return true;
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    uint32_t s1 = hash_cuckoo1(entry & 0xFFF, (entry >> 12) & 0xFF);
+    if (Dictionary_code(Dictionary_load(slot, false)) == 0) {
+        Dictionary_store(slot, entry);
+        return true;
+    }
+    if (Dictionary_code(Dictionary_load(DICTIONARY_CUCKOO_SIZE + s1, false)) == 0) {
+        Dictionary_store(DICTIONARY_CUCKOO_SIZE + s1, entry);
+        return true;
+    }
+    return false;
+#else
+    // The probe stopped on the first free slot of the sequence: that is where the string goes.
+    Dictionary_store(slot, entry);
+    return true;
+#endif
+}
+
+bool Dictionary_kick(Dictionary *moving, uint32_t *addr, uint32_t *kicks) {
+    #pragma HLS INLINE
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    // One displacement: the evicted entry moves to its slot in the other bank.
+    Dictionary victim = Dictionary_load(*addr, false);
+    Dictionary_store(*addr, *moving);
+    if (Dictionary_code(victim) == 0) return true;
 
-        if (bit_offset == 0) output[byte_index] = 0;
+    uint16_t prefix = victim & 0xFFF;
+    uint8_t ext = (victim >> 12) & 0xFF;
+    *moving = victim;
+    *addr = (*addr >= DICTIONARY_CUCKOO_SIZE) ? hash_cuckoo0(prefix, ext) : DICTIONARY_CUCKOO_SIZE + hash_cuckoo1(prefix, ext);
+    (*kicks)++;
+    if (*kicks < DICTIONARY_CUCKOO_MAX_KICKS) return false;
 
-        output[byte_index] |= mask << (space_in_byte - bits_to_write);
-        bit_offset += bits_to_write;
-        if (bit_offset == 8) {
-            bit_offset = 0;
-            byte_index++;
+    // Still homeless: park it in the stash, or drop it when the stash is full
+    // (its code stays allocated, the encoder just never matches it again).
+    bool placed = false;
+    for (uint32_t i = 0; i < DICTIONARY_STASH_SIZE; i++) {
+        #pragma HLS UNROLL
+        if (!placed && Dictionary_code(dictionary_stash[i]) == 0) {
+            dictionary_stash[i] = victim;
+            placed = true;
         }
-        bits_left -= bits_to_write;
     }
-    *out_index += bit_count;
+#else
+    (void)moving;
+    (void)addr;
+    (void)kicks;
+#endif
+    return true;
+}
+
+static void Output_emit(uint16_t code, uint8_t bit_count, uint32_t *acc, uint8_t *pending_bits) {
+    #pragma HLS INLINE
+    LZW_PERF_ADD(LZW_PERF_CODES_OUT, 1);
+    *acc = (*acc << bit_count) | code;
+    *pending_bits += bit_count;
+}
+
+static void Successor_record(uint16_t prefix, uint8_t ext, uint16_t code) {
+    #pragma HLS INLINE
+#if LZW_SPECULATIVE
+    dictionary_successor[prefix] = Dictionary_pack(prefix, ext, code);
+#else
+    (void)prefix;
+    (void)ext;
+    (void)code;
+#endif
+}
+
+uint32_t Crc32_update(uint32_t crc, uint8_t byte) {
+    #pragma HLS INLINE
+    // Bitwise form: eight XOR levels per byte, no table to store.
+    crc ^= byte;
+    for (int i = 0; i < 8; i++) {
+        #pragma HLS UNROLL
+        crc = (crc >> 1) ^ (CRC32_POLY & (0u - (crc & 1)));
+    }
+    return crc;
 }
 
 /**************************  Main Function Declaration ******************************/
-void lzw_compress(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size){
+void lzw_compress(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size,
+                  uint32_t *input_crc, uint32_t *output_crc, uint32_t perf_counters[LZW_PERF_COUNT]){
+#if LZW_SPECULATIVE
+    #pragma HLS INTERFACE m_axi depth=input_size port=input offset=slave bundle=AXIM_A max_widen_bitwidth=64
+#else
     #pragma HLS INTERFACE m_axi depth=input_size port=input offset=slave bundle=AXIM_A
+#endif
     #pragma HLS INTERFACE m_axi depth=input_size port=output offset=slave bundle=AXIM_A
     #pragma HLS INTERFACE s_axilite port=input   bundle=control
     #pragma HLS INTERFACE s_axilite port=output  bundle=control
     #pragma HLS INTERFACE s_axilite port=return  bundle=control
     #pragma HLS INTERFACE s_axilite port=input_size    bundle=control
     #pragma HLS INTERFACE s_axilite port=compression_size bundle=control
+    #pragma HLS INTERFACE s_axilite port=input_crc bundle=control
+    #pragma HLS INTERFACE s_axilite port=output_crc bundle=control
+    #pragma HLS INTERFACE s_axilite port=perf_counters bundle=control
+    #pragma HLS ARRAY_PARTITION variable=lzw_perf complete
+    #pragma HLS ARRAY_PARTITION variable=dictionary_forward_addr complete
+    #pragma HLS ARRAY_PARTITION variable=dictionary_forward_entry complete
+#if DICTIONARY_CACHE_SIZE > 0
+    #pragma HLS ARRAY_PARTITION variable=dictionary_cache complete
+#endif
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    #pragma HLS ARRAY_PARTITION variable=dictionary complete dim=2
+    #pragma HLS ARRAY_PARTITION variable=dictionary_tag complete dim=2
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    #pragma HLS ARRAY_PARTITION variable=dictionary complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=dictionary_tag complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=dictionary_stash complete
+#endif
+    #pragma HLS BIND_STORAGE variable=dictionary type=ram_2p impl=bram
+    #pragma HLS BIND_STORAGE variable=dictionary_tag type=ram_2p impl=bram
+#if LZW_SPECULATIVE
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+    #pragma HLS ARRAY_PARTITION variable=dictionary_shadow complete dim=2
+    #pragma HLS ARRAY_PARTITION variable=dictionary_shadow_tag complete dim=2
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+    #pragma HLS ARRAY_PARTITION variable=dictionary_shadow complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=dictionary_shadow_tag complete dim=1
+#endif
+    #pragma HLS BIND_STORAGE variable=dictionary_shadow type=ram_2p impl=bram
+    #pragma HLS BIND_STORAGE variable=dictionary_shadow_tag type=ram_2p impl=bram
+    #pragma HLS BIND_STORAGE variable=dictionary_successor type=ram_2p impl=bram
+#endif
+
+    for (uint32_t i = 0; i < LZW_PERF_COUNT; i++){
+        #pragma HLS UNROLL
+        lzw_perf[i] = 0;
+    }
 
-    uint16_t dictionary_size = 256;
-    uint8_t bit_count = 8;
-    uint32_t out_index = 0;
-    
     if (input_size == 0) {
         *compression_size = 0;
+        *input_crc = 0;
+        *output_crc = 0;
+        Perf_copy(perf_counters);
         return;
     }
-    
-    if (input_size == 1) {
-        write_output(input[0], output, bit_count, &out_index);
-        *compression_size = (out_index + 7) /8;
+
+    uint16_t dictionary_size = 256;
+    uint8_t bit_count = 8;
+    uint32_t acc = 0;               // Bit accumulator, the pending bits are the low ones
+    uint8_t pending_bits = 0;
+    uint32_t out_bytes = 0;
+
+    uint16_t prefix = input[0];
+    uint8_t ext = 0;
+    int pos = 1;
+    uint32_t in_crc = Crc32_update(CRC32_INIT, prefix);
+    uint32_t out_crc = CRC32_INIT;
+    LZW_PERF_ADD(LZW_PERF_BYTES_IN, 1);
+    LZW_PERF_ADD(LZW_PERF_AXI_READS, 1);
+
+    uint32_t probe = 0;
+    uint32_t slot = 0;
+    uint32_t row = 0;
+    uint32_t pending_row = DICTIONARY_NO_ADDR;
+    Dictionary pending_entry = 0;
+    Dictionary moving = 0;
+    uint32_t kick_addr = 0;
+    uint32_t kicks = 0;
+
+#if LZW_SPECULATIVE
+    // The matcher reads up to two bytes per cycle, more than the byte-wide port delivers:
+    // the input is staged block by block through a widened burst.
+    uint8_t input_block[LZW_INPUT_BLOCK_SIZE];
+    #pragma HLS ARRAY_PARTITION variable=input_block cyclic factor=2
+    int block_start = pos;
+    int block_end = pos;
+#endif
+
+    // A single byte needs no dictionary. Otherwise the job starts on a new epoch, so the table is
+    // already empty, unless the epoch wrapped and the rows must be cleared first.
+    uint8_t state = LZW_STATE_READ;
+    if (input_size > 1 && Dictionary_new_epoch()) state = LZW_STATE_CLEAR;
+    Dictionary_cache_invalidate();
+
+    // One pass per input block in the speculative build, a single pass otherwise.
+    while (state != LZW_STATE_DONE) {
+#if LZW_SPECULATIVE
+        if (pos == block_end && pos < input_size) {
+            int count = (input_size - pos < LZW_INPUT_BLOCK_SIZE) ? input_size - pos : LZW_INPUT_BLOCK_SIZE;
+            memcpy(input_block, input + pos, count);
+            block_start = pos;
+            block_end = pos + count;
+            // 64-bit beats once the port is widened.
+            LZW_PERF_ADD(LZW_PERF_AXI_READS, (count + 7) / 8);
+            LZW_PERF_ADD(LZW_PERF_CYCLES, (count + 7) / 8);
+        }
+#endif
+
+        // One iteration per cycle. A hit that the cache or the first probe resolves costs one iteration per byte;
+        // collisions, cuckoo displacements, dictionary clears and output back-pressure add iterations.
+        while (state != LZW_STATE_DONE) {
+            #pragma HLS PIPELINE II=1
+            #pragma HLS DEPENDENCE variable=dictionary inter distance=DICTIONARY_FORWARD_DISTANCE true
+            #pragma HLS DEPENDENCE variable=dictionary_tag inter distance=DICTIONARY_FORWARD_DISTANCE true
+#if LZW_SPECULATIVE
+            #pragma HLS DEPENDENCE variable=dictionary_shadow inter distance=DICTIONARY_FORWARD_DISTANCE true
+            #pragma HLS DEPENDENCE variable=dictionary_shadow_tag inter distance=DICTIONARY_FORWARD_DISTANCE true
+            // A stale successor only makes the guess miss: the second lookup is checked against the first.
+            #pragma HLS DEPENDENCE variable=dictionary_successor inter false
+            if (state == LZW_STATE_READ && pos == block_end && pos < input_size) break;
+#endif
+            LZW_PERF_ADD(LZW_PERF_CYCLES, 1);
+            Dictionary_hazard_tick(false);
+
+            // At most one output byte per iteration, drained before this iteration emits anything.
+            bool drained = false;
+            if (pending_bits >= 8) {
+                output[out_bytes] = acc >> (pending_bits - 8);
+                out_crc = Crc32_update(out_crc, acc >> (pending_bits - 8));
+                out_bytes++;
+                pending_bits -= 8;
+                drained = true;
+                LZW_PERF_ADD(LZW_PERF_AXI_WRITES, 1);
+            }
+
+            bool resolve = false;
+            uint16_t code = INVALID_CODE;
+            switch (state) {
+            case LZW_STATE_CLEAR:
+                // DICTIONARY_FORWARD_DEPTH settle iterations after the last row, so the first lookup is
+                // DICTIONARY_FORWARD_DISTANCE iterations after the last row write.
+                if (row < DICTIONARY_ROWS) Dictionary_clear_row(row, pending_row, pending_entry);
+                else if (row == DICTIONARY_ROWS + DICTIONARY_FORWARD_DEPTH - 1) state = LZW_STATE_READ;
+                row++;
+                break;
+            case LZW_STATE_READ: {
+                // Stall while the accumulator could not take another code.
+                if (pending_bits > OUTPUT_STALL_BITS) break;
+                if (pos == input_size) {
+                    Output_emit(prefix, bit_count, &acc, &pending_bits);
+                    state = LZW_STATE_FLUSH;
+                    break;
+                }
+#if LZW_SPECULATIVE
+                ext = input_block[pos - block_start];
+#else
+                ext = input[pos];
+                LZW_PERF_ADD(LZW_PERF_AXI_READS, 1);
+#endif
+                in_crc = Crc32_update(in_crc, ext);
+                pos++;
+                LZW_PERF_ADD(LZW_PERF_BYTES_IN, 1);
+
+                code = Dictionary_cache_find(prefix, ext);
+#ifndef __SYNTHESIS__
+                dictionary_cache_lookups++;
+                if (code != INVALID_CODE) dictionary_cache_hits++;
+#endif
+                bool cached = (code != INVALID_CODE);
+                if (!cached) {
+                    code = Dictionary_probe(prefix, ext, 0, &slot, false);
+                    probe = 1;
+                }
+
+#if LZW_SPECULATIVE
+                // Second byte in the same cycle: the successor table guesses the code of (prefix, ext) and
+                // (guess, next byte) is looked up in the cache and the shadow table alongside the first lookup.
+                // The second result is only used when the guess was right.
+                if (code < DICTIONARY_PROBE_AGAIN && pos < block_end && Dictionary_code(dictionary_successor[prefix]) == code) {
+                    uint8_t ext2 = input_block[pos - block_start];
+                    if (!cached) {
+                        Perf_probes(1);
+                        Dictionary_cache_insert(prefix, ext, code);
+                    }
+                    uint16_t code2 = Dictionary_cache_find(code, ext2);
+                    bool cached2 = (code2 != INVALID_CODE);
+                    uint32_t slot2 = 0;
+                    if (!cached2) code2 = Dictionary_probe(code, ext2, 0, &slot2, true);
+
+                    if (code2 == DICTIONARY_PROBE_AGAIN) {
+                        // Collision in the second lookup: only the first byte is consumed this cycle.
+                        prefix = code;
+                        break;
+                    }
+#ifndef __SYNTHESIS__
+                    dictionary_cache_lookups++;
+                    if (cached2) dictionary_cache_hits++;
+#endif
+                    pos++;
+                    in_crc = Crc32_update(in_crc, ext2);
+                    LZW_PERF_ADD(LZW_PERF_BYTES_IN, 1);
+                    LZW_PERF_ADD(LZW_PERF_SPECULATED, 1);
+                    prefix = code;
+                    ext = ext2;
+                    slot = slot2;
+                    probe = 1;
+                    code = code2;
+                    cached = cached2;
+                }
+#endif
+                if (cached) {
+                    Successor_record(prefix, ext, code);
+                    prefix = code;
+                    break;
+                }
+                resolve = true;
+                break;
+            }
+            case LZW_STATE_PROBE:
+                code = Dictionary_probe(prefix, ext, probe, &slot, false);
+                probe++;
+                resolve = true;
+                break;
+            case LZW_STATE_KICK:
+                if (Dictionary_kick(&moving, &kick_addr, &kicks)) state = LZW_STATE_READ;
+                LZW_PERF_ADD(LZW_PERF_PROBES, 1);
+                break;
+            case LZW_STATE_FLUSH:
+                if (!drained && pending_bits > 0) {
+                    // Last partial byte, zero padded.
+                    output[out_bytes] = acc << (8 - pending_bits);
+                    out_crc = Crc32_update(out_crc, acc << (8 - pending_bits));
+                    out_bytes++;
+                    pending_bits = 0;
+                    LZW_PERF_ADD(LZW_PERF_AXI_WRITES, 1);
+                }
+                if (pending_bits == 0) state = LZW_STATE_DONE;
+                break;
+            default:
+                break;
+            }
+
+            if (resolve) {
+                if (code == DICTIONARY_PROBE_AGAIN) {
+                    state = LZW_STATE_PROBE;
+                } else if (code != INVALID_CODE) {
+                    Perf_probes(probe);
+                    Dictionary_cache_insert(prefix, ext, code);
+                    Successor_record(prefix, ext, code);
+                    prefix = code;
+                    state = LZW_STATE_READ;
+                } else {
+                    Perf_probes(probe);
+                    Output_emit(prefix, bit_count, &acc, &pending_bits);
+
+                    bool reset = dictionary_size >= MAX_DICTIONARY_SIZE;
+                    if (reset) {
+                        LZW_PERF_ADD(LZW_PERF_RESETS, 1);
+                        dictionary_size = 256;
+                        bit_count = 8;
+                        Dictionary_cache_invalidate();
+                    }
+                    if (dictionary_size >= (1u << bit_count)) bit_count++;
+                    Dictionary_cache_insert(prefix, ext, dictionary_size);
+                    Successor_record(prefix, ext, dictionary_size);
+                    Dictionary added = Dictionary_pack(prefix, ext, dictionary_size);
+                    dictionary_size++;
+
+                    if (reset && Dictionary_new_epoch()) {
+                        pending_entry = added;
+                        pending_row = Dictionary_first_row(prefix, ext);
+                        row = 0;
+                        state = LZW_STATE_CLEAR;
+                    } else if (reset) {
+                        // The new epoch left the table empty: the entry takes the first slot of its probe sequence.
+                        Dictionary_insert(added, Dictionary_first_row(prefix, ext));
+                        state = LZW_STATE_READ;
+                    } else if (Dictionary_insert(added, slot)) {
+                        state = LZW_STATE_READ;
+                    } else {
+                        moving = added;
+                        kick_addr = slot;
+                        kicks = 0;
+                        state = LZW_STATE_KICK;
+                    }
+                    prefix = ext;
+                }
+            }
+        }
+    }
+
+    Dictionary_hazard_tick(true);
+    *compression_size = out_bytes;
+    *input_crc = in_crc ^ CRC32_INIT;
+    *output_crc = out_crc ^ CRC32_INIT;
+    Perf_copy(perf_counters);
+}
+
+/**************************  LZ4 Function Declaration ******************************/
+static uint32_t Lz4_hash(uint32_t seq) {
+    #pragma HLS INLINE
+    return (seq * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+/* Returns the byte at pos, reading it into the window (and the input CRC) first if it is the next unread one. */
+static uint8_t Lz4_fetch(uint8_t *input, uint32_t pos, uint32_t *loaded, uint32_t *crc) {
+    #pragma HLS INLINE
+    if (pos == *loaded) {
+        uint8_t byte = input[pos];
+        lz4_window[pos & (LZ4_WINDOW_SIZE - 1)] = byte;
+        *crc = Crc32_update(*crc, byte);
+        (*loaded)++;
+    }
+    return lz4_window[pos & (LZ4_WINDOW_SIZE - 1)];
+}
+
+static void Lz4_put(uint8_t *output, uint32_t *out, uint32_t *crc, uint8_t byte) {
+    #pragma HLS INLINE
+    output[(*out)++] = byte;
+    *crc = Crc32_update(*crc, byte);
+}
+
+static void Lz4_put_length(uint8_t *output, uint32_t *out, uint32_t *crc, uint32_t length) {
+    for (; length >= 255; length -= 255) {
+        #pragma HLS PIPELINE II=1
+        Lz4_put(output, out, crc, 255);
+    }
+    Lz4_put(output, out, crc, length);
+}
+
+/* One sequence; a zero match_length writes the last, literal-only sequence. */
+static void Lz4_put_sequence(uint8_t *input, uint8_t *output, uint32_t *out, uint32_t *crc, uint32_t anchor,
+                             uint32_t literal_length, uint32_t offset, uint32_t match_length) {
+    uint32_t ml_code = match_length ? match_length - LZ4_MIN_MATCH : 0;
+
+    Lz4_put(output, out, crc, ((literal_length < 15 ? literal_length : 15) << 4) | (ml_code < 15 ? ml_code : 15));
+    if (literal_length >= 15) Lz4_put_length(output, out, crc, literal_length - 15);
+    for (uint32_t i = 0; i < literal_length; i++) {
+        #pragma HLS PIPELINE II=1
+        Lz4_put(output, out, crc, input[anchor + i]);
+    }
+
+    if (match_length == 0) return;
+    Lz4_put(output, out, crc, offset);
+    Lz4_put(output, out, crc, offset >> 8);
+    if (ml_code >= 15) Lz4_put_length(output, out, crc, ml_code - 15);
+}
+
+void lz4_compress(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size,
+                  uint32_t *input_crc, uint32_t *output_crc){
+    #pragma HLS INTERFACE m_axi depth=input_size port=input offset=slave bundle=AXIM_A
+    #pragma HLS INTERFACE m_axi depth=input_size port=output offset=slave bundle=AXIM_A
+    #pragma HLS INTERFACE s_axilite port=input   bundle=control
+    #pragma HLS INTERFACE s_axilite port=output  bundle=control
+    #pragma HLS INTERFACE s_axilite port=return  bundle=control
+    #pragma HLS INTERFACE s_axilite port=input_size    bundle=control
+    #pragma HLS INTERFACE s_axilite port=compression_size bundle=control
+    #pragma HLS INTERFACE s_axilite port=input_crc bundle=control
+    #pragma HLS INTERFACE s_axilite port=output_crc bundle=control
+    #pragma HLS BIND_STORAGE variable=lz4_table type=ram_2p impl=bram
+    #pragma HLS BIND_STORAGE variable=lz4_window type=ram_2p impl=bram
+
+    uint32_t out = 0;
+    uint32_t anchor = 0;
+    uint32_t pos = 0;
+    uint32_t loaded = 0;
+    uint32_t in_crc = CRC32_INIT;
+    uint32_t out_crc = CRC32_INIT;
+
+    if (input_size <= 0) {
+        Lz4_put(output, &out, &out_crc, 0);
+        *compression_size = out;
+        *input_crc = 0;
+        *output_crc = out_crc ^ CRC32_INIT;
         return;
     }
 
-    init_dictionary();
+    for (uint32_t i = 0; i < (1u << LZ4_HASH_BITS); i++) {
+        #pragma HLS PIPELINE II=1
+        lz4_table[i] = 0;
+    }
 
-    uint16_t prefix = input[0];
-    uint8_t ext = input[1];
-
-    write_output(prefix, output, bit_count, &out_index);
-    Dictionary_add(prefix, ext, &dictionary_size, &bit_count);
-    prefix = ext;
-
-    for (int i = 2; i < input_size; i++){ 
-        uint8_t ext = input[i];
-        uint16_t code = Dictionary_find(prefix, ext);
-        if (code != INVALID_CODE){
-            prefix = code;
-        } else {
-            write_output(prefix, output, bit_count, &out_index);
-            Dictionary_add(prefix, ext, &dictionary_size, &bit_count);
-            prefix = ext;
+    if (input_size > LZ4_MFLIMIT) {
+        uint32_t mflimit = input_size - LZ4_MFLIMIT;
+        uint32_t matchlimit = input_size - LZ4_LAST_LITERALS;
+
+        uint32_t seq = 0;
+        for (uint32_t i = 0; i < 4; i++) seq |= (uint32_t)Lz4_fetch(input, i, &loaded, &in_crc) << (8 * i);
+
+        while (pos <= mflimit) {
+            uint32_t h = Lz4_hash(seq);
+            uint32_t candidate = lz4_table[h];         // Position + 1, 0 for an empty slot
+            lz4_table[h] = pos + 1;
+
+            uint32_t match = candidate - 1;
+            bool found = candidate != 0 && pos - match <= LZ4_MAX_DISTANCE;
+            for (uint32_t i = 0; i < 4; i++) {
+                #pragma HLS UNROLL
+                if (found && lz4_window[(match + i) & (LZ4_WINDOW_SIZE - 1)] != ((seq >> (8 * i)) & 0xFF)) found = false;
+            }
+
+            if (found) {
+                uint32_t match_length = LZ4_MIN_MATCH;
+                while (pos + match_length < matchlimit) {
+                    #pragma HLS PIPELINE II=1
+                    #pragma HLS LOOP_TRIPCOUNT max=LZ4_WINDOW_SIZE
+                    if (lz4_window[(match + match_length) & (LZ4_WINDOW_SIZE - 1)] != Lz4_fetch(input, pos + match_length, &loaded, &in_crc)) break;
+                    match_length++;
+                }
+
+                Lz4_put_sequence(input, output, &out, &out_crc, anchor, pos - anchor, pos - match, match_length);
+                pos += match_length;
+                anchor = pos;
+
+                seq = 0;
+                for (uint32_t i = 0; i < 4; i++) seq |= (uint32_t)Lz4_fetch(input, pos + i, &loaded, &in_crc) << (8 * i);
+            } else {
+                pos++;
+                seq = (seq >> 8) | ((uint32_t)Lz4_fetch(input, pos + 3, &loaded, &in_crc) << 24);
+            }
         }
     }
-    write_output(prefix, output, bit_count, &out_index);
 
-    while (out_index % 8 != 0) {
-        output[out_index / 8] |= (0 << (7 - out_index % 8));
-        out_index++;
+    Lz4_put_sequence(input, output, &out, &out_crc, anchor, input_size - anchor, 0, 0);
+
+    // The tail after the last byte the parse looked at only went through the literal copy.
+    for (uint32_t i = loaded; i < (uint32_t)input_size; i++) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT max=LZ4_MFLIMIT
+        in_crc = Crc32_update(in_crc, input[i]);
+    }
+
+    *compression_size = out;
+    *input_crc = in_crc ^ CRC32_INIT;
+    *output_crc = out_crc ^ CRC32_INIT;
+}
+
+/**************************  Job Ring Function Declaration ******************************/
+void lzw_compress_ring(volatile LzwRingControl *control, LzwJob *jobs, LzwCompletion *completions, uint8_t *memory, uint32_t ring_size){
+    #pragma HLS INTERFACE m_axi depth=1 port=control offset=slave bundle=AXIM_RING
+    #pragma HLS INTERFACE m_axi depth=ring_size port=jobs offset=slave bundle=AXIM_RING
+    #pragma HLS INTERFACE m_axi depth=ring_size port=completions offset=slave bundle=AXIM_RING
+    #pragma HLS INTERFACE m_axi port=memory offset=slave bundle=AXIM_A
+    #pragma HLS INTERFACE s_axilite port=control     bundle=control
+    #pragma HLS INTERFACE s_axilite port=jobs        bundle=control
+    #pragma HLS INTERFACE s_axilite port=completions bundle=control
+    #pragma HLS INTERFACE s_axilite port=memory      bundle=control
+    #pragma HLS INTERFACE s_axilite port=ring_size   bundle=control
+    #pragma HLS INTERFACE s_axilite port=return      bundle=control
+
+    uint32_t head = 0;
+
+    while (1) {
+        uint32_t tail = control->tail;
+        if (head == tail) {
+            if (control->stop) break;
+            continue;
+        }
+
+        uint32_t slot = head & (ring_size - 1);
+        LzwJob job = jobs[slot];
+        uint32_t compression_size = 0;
+        uint32_t input_crc = 0;
+        uint32_t output_crc = 0;
+        uint32_t perf_counters[LZW_PERF_COUNT];
+        uint32_t status = LZW_JOB_INVALID;
+
+        if (job.flags == 0) {
+            // Counters are per job and the ring has no register to return them in: they are dropped here.
+            lzw_compress(memory + job.src, memory + job.dst, job.len, &compression_size, &input_crc, &output_crc, perf_counters);
+            status = LZW_JOB_DONE;
+        } else if (job.flags == LZW_JOB_FLAG_LZ4) {
+            lz4_compress(memory + job.src, memory + job.dst, job.len, &compression_size, &input_crc, &output_crc);
+            status = LZW_JOB_DONE;
+        }
+
+        // Built on chip and written as one 32-byte burst, its sequence word last.
+        LzwCompletion completion;
+        completion.compressed_size = compression_size;
+        completion.status = status;
+        completion.input_crc = input_crc;
+        completion.output_crc = output_crc;
+        completion.reserved[0] = 0;
+        completion.reserved[1] = 0;
+        completion.reserved[2] = 0;
+        completion.sequence = head + 1;
+        completions[slot] = completion;
+        head++;
     }
-    
-    *compression_size = (out_index + 7) /8;
-}
\ No newline at end of file
+}
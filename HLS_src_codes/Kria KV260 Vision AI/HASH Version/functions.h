@@ -9,23 +9,256 @@
 
 /************************** Constant Definitions ******************************/
 #define MAX_DICTIONARY_SIZE  4096           // Maximum size of the LZW dictionary (12-bit codes)
+#define MAX_CODE_BITS        12             // Widest code written to the output
 #define INVALID_CODE         0xFFFF         // Used to represent an invalid or non-existent code
+#define DICTIONARY_PROBE_AGAIN 0xFFFE       // Dictionary_probe hit an occupied slot of another string
+#define DICTIONARY_NO_ADDR   0xFFFFFFFF     // No table address (no pending entry, empty forwarding slot)
+
+/* lzw_compress main loop states */
+#define LZW_STATE_CLEAR             0       // Table clear when the epoch wraps, one row cleared per iteration, then the settle
+#define LZW_STATE_READ              1       // Read the next byte, look it up in the cache and probe the table
+#define LZW_STATE_PROBE             2       // Collision: probe the next slot of the sequence (linear layout)
+#define LZW_STATE_KICK              3       // Cuckoo displacement, one kick per iteration (cuckoo layout)
+#define LZW_STATE_FLUSH             4       // Input consumed, draining the bit accumulator
+#define LZW_STATE_DONE              5
+
+/* Output bit accumulator (32 bits): no byte is read while it holds more than this, so a code always fits */
+#define OUTPUT_STALL_BITS           (32 - MAX_CODE_BITS)
+
+/* Dictionary table layouts, selected at build time with DICTIONARY_LAYOUT */
+#define DICTIONARY_LAYOUT_LINEAR    0       // Single 4096-slot table searched by a double-hashed probe loop
+#define DICTIONARY_LAYOUT_BUCKETED  1       // Set-associative buckets, all ways of a bucket compared in one cycle
+#define DICTIONARY_LAYOUT_CUCKOO    2       // Two cuckoo-hashed banks plus a stash, looked up in parallel
+
+#ifndef DICTIONARY_LAYOUT
+#define DICTIONARY_LAYOUT           DICTIONARY_LAYOUT_LINEAR
+#endif
+
+/*
+ * Dictionary hash functions, selected at build time with LZW_HASH_FUNCTION (compared on recorded
+ * dictionary operations by Benchmark_Src_Codes/hash_eval.c). The output does not depend on it with the
+ * linear layout, only the probe count does; with the bucketed and cuckoo layouts it also decides which
+ * inserts are dropped.
+ */
+#define LZW_HASH_SHIFT_XOR          0       // hash1/hash2 from shifts and XORs, multiplicative buckets and bank 0
+#define LZW_HASH_MULTIPLICATIVE     1       // Top bits of key * 2654435761 (one DSP multiply)
+#define LZW_HASH_CRC                2       // CRC-32 of the 20-bit key (an XOR tree, no DSP)
+
+#ifndef LZW_HASH_FUNCTION
+#define LZW_HASH_FUNCTION           LZW_HASH_CRC
+#endif
+
+/*
+ * Bucketed layout geometry: 2^DICTIONARY_BUCKET_BITS buckets of DICTIONARY_BUCKET_WAYS entries.
+ * e.g. 11 bits x 4 ways (8192 slots) or 12 bits x 2 ways (8192 slots).
+ */
+#ifndef DICTIONARY_BUCKET_BITS
+#define DICTIONARY_BUCKET_BITS      11
+#endif
+#ifndef DICTIONARY_BUCKET_WAYS
+#define DICTIONARY_BUCKET_WAYS      4
+#endif
+#define DICTIONARY_BUCKET_COUNT     (1u << DICTIONARY_BUCKET_BITS)
+
+/*
+ * Cuckoo layout geometry: two banks of 2^DICTIONARY_CUCKOO_BITS slots each. An insert displaces
+ * at most DICTIONARY_CUCKOO_MAX_KICKS entries before the homeless one goes to the stash.
+ */
+#ifndef DICTIONARY_CUCKOO_BITS
+#define DICTIONARY_CUCKOO_BITS      12
+#endif
+#ifndef DICTIONARY_CUCKOO_MAX_KICKS
+#define DICTIONARY_CUCKOO_MAX_KICKS 16
+#endif
+#ifndef DICTIONARY_STASH_SIZE
+#define DICTIONARY_STASH_SIZE       4
+#endif
+#define DICTIONARY_CUCKOO_SIZE      (1u << DICTIONARY_CUCKOO_BITS)
+
+/*
+ * Dictionary epochs: every table slot carries a tag with the epoch it was written in, and only the slots of the
+ * current epoch hold entries, so a new dictionary (job start or reset) is a single increment. The rows are only
+ * cleared one by one (LZW_STATE_CLEAR) once every 2^DICTIONARY_EPOCH_BITS dictionaries, when the epoch wraps (1-8 bits).
+ */
+#ifndef DICTIONARY_EPOCH_BITS
+#define DICTIONARY_EPOCH_BITS       8
+#endif
+#define DICTIONARY_EPOCH_MASK       ((1u << DICTIONARY_EPOCH_BITS) - 1)
+
+/*
+ * Store-to-load forwarding of the main loop. The table is declared free of dependences below
+ * DICTIONARY_FORWARD_DISTANCE iterations, so a lookup issues every cycle while the stores of the previous
+ * iterations are still in flight: the last DICTIONARY_FORWARD_DEPTH stores are kept in registers and override
+ * the slot read. The dependence at DICTIONARY_FORWARD_DISTANCE is declared true, so a schedule whose
+ * load-to-store distance exceeds the window fails II=1 in the synthesis report instead of reading stale slots.
+ * 4 covers a 2-cycle BRAM read, the key compare and the store.
+ */
+#ifndef DICTIONARY_FORWARD_DEPTH
+#define DICTIONARY_FORWARD_DEPTH    4
+#endif
+#define DICTIONARY_FORWARD_DISTANCE (DICTIONARY_FORWARD_DEPTH + 1)
+
+/*
+ * C simulation only: table writes land DICTIONARY_HAZARD_DISTANCE iterations after the one that issued them,
+ * the latest the DEPENDENCE pragmas allow, so a lookup the forwarding window or the clear settle misses reads
+ * a stale slot and changes the output (0 writes at once).
+ */
+#ifndef DICTIONARY_HAZARD_CHECK
+#define DICTIONARY_HAZARD_CHECK     0
+#endif
+#ifndef DICTIONARY_HAZARD_DISTANCE
+#define DICTIONARY_HAZARD_DISTANCE  DICTIONARY_FORWARD_DISTANCE
+#endif
+
+/* Rows cleared when the epoch wraps, one per main loop iteration */
+#if DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_BUCKETED
+#define DICTIONARY_ROWS             DICTIONARY_BUCKET_COUNT
+#elif DICTIONARY_LAYOUT == DICTIONARY_LAYOUT_CUCKOO
+#define DICTIONARY_ROWS             DICTIONARY_CUCKOO_SIZE
+#else
+#define DICTIONARY_ROWS             MAX_DICTIONARY_SIZE
+#endif
+
+/* Packed entry fields (see Dictionary) */
+#define DICTIONARY_KEY_MASK         0x000FFFFF     // Prefix code and extension byte
+#define DICTIONARY_CODE_SHIFT       20
+
+/*
+ * Speculative two-byte matcher (0 disables it): every cycle also looks up the following byte with the code a
+ * successor table predicts for the first lookup, in a duplicated dictionary, and consumes both bytes when the
+ * prediction holds. The input is then staged through an on-chip block of LZW_INPUT_BLOCK_SIZE bytes.
+ */
+#ifndef LZW_SPECULATIVE
+#define LZW_SPECULATIVE             0
+#endif
+#define LZW_INPUT_BLOCK_SIZE        4096
+
+/* Fully associative cache of recently matched or inserted pairs, checked before the table (0 disables it) */
+#ifndef DICTIONARY_CACHE_SIZE
+#define DICTIONARY_CACHE_SIZE       8
+#endif
+
+/*
+ * Performance counters returned by lzw_compress in perf_counters[], indexed by LZW_PERF_*.
+ * LZW_PERF_COUNTERS = 0 compiles the counting logic out; the port is kept and reads 0.
+ */
+#ifndef LZW_PERF_COUNTERS
+#define LZW_PERF_COUNTERS           1
+#endif
+#define LZW_PERF_CYCLES             0       // Busy cycles (main loop iterations)
+#define LZW_PERF_BYTES_IN           1       // Input bytes consumed
+#define LZW_PERF_CODES_OUT          2       // Codes emitted
+#define LZW_PERF_PROBES             3       // Dictionary table probe iterations (find + add)
+#define LZW_PERF_PROBE_MAX          4       // Longest single probe sequence
+#define LZW_PERF_RESETS             5       // Dictionary resets (new dictionary of the job excluded)
+#define LZW_PERF_AXI_READS          6       // Beats read on AXIM_A
+#define LZW_PERF_AXI_WRITES         7       // Beats written on AXIM_A
+#define LZW_PERF_SPECULATED         8       // Cycles that consumed two bytes (LZW_SPECULATIVE)
+#define LZW_PERF_COUNT              9
+
+/* CRC-32 of the input and of the output (IEEE 802.3, the zlib crc32 of the whole buffer) */
+#define CRC32_POLY                  0xEDB88320
+#define CRC32_INIT                  0xFFFFFFFF      // Start value, also XORed into the final value
+
+/* Job ring (lzw_compress_ring) */
+#define LZW_JOB_DONE                1       // Job compressed, compressed_size is valid
+#define LZW_JOB_INVALID             2       // Job rejected (unsupported flags)
+#define LZW_JOB_FLAG_LZ4            0x1     // Compress the job with lz4_compress instead of lzw_compress
+
+/*
+ * LZ4 engine (lz4_compress): greedy parse with one match-table probe per position, emitting the
+ * LZ4 block format. Must match Sw_Src_Codes/LZ4/lz4_block.h, so both produce identical blocks.
+ */
+#define LZ4_HASH_BITS               12      // Match table of 4096 positions
+#define LZ4_WINDOW_SIZE             16384   // On-chip history matches are checked against (power of two)
+#define LZ4_MAX_DISTANCE            (LZ4_WINDOW_SIZE - 4)
+#define LZ4_MIN_MATCH               4
+#define LZ4_LAST_LITERALS           5       // The block always ends with at least 5 literals
+#define LZ4_MFLIMIT                 12      // No match starts in the last 12 bytes
 
 /**************************** Type Definitions *******************************/
 /**
- * @brief Dictionary entry used for LZW compression.
+ * @brief Dictionary entry used for LZW compression, packed in one 32-bit word:
+ *        bits 0-11 prefix code, bits 12-19 extension byte, bits 20-31 assigned code.
+ *        Stored codes are always >= 256, so a zero code marks a free slot and no separate
+ *        used array is needed. Each table slot also has an epoch tag, kept in a narrow array beside
+ *        the entries: a slot tagged with an older epoch reads as free.
+ */
+typedef uint32_t Dictionary;
+
+/**
+ * @brief Job descriptor of the job ring, written by the host.
+ *        src and dst are byte offsets from the memory port of lzw_compress_ring.
  */
 typedef struct {
-    uint16_t prefix_code;  // Code of the previous sequence
-    uint8_t ext_byte;      // New byte to add to the sequence
-    uint16_t code;         // Assigned code for the new sequence
-} Dictionary;
+    uint32_t src;          // Offset of the input record
+    uint32_t dst;          // Offset of the output buffer (2 * len + 1 bytes)
+    uint32_t len;          // Input record size in bytes
+    uint32_t flags;        // 0 for LZW, LZW_JOB_FLAG_LZ4 for LZ4
+} LzwJob;
+
+/**
+ * @brief Completion record of the job ring, written by the core at the same index as the job.
+ *        The core writes the whole record in one burst, in address order, so sequence lands last: once
+ *        it matches, the other fields belong to the same job.
+ */
+typedef struct {
+    uint32_t compressed_size;  // Compressed size in bytes
+    uint32_t status;           // LZW_JOB_DONE or LZW_JOB_INVALID
+    uint32_t input_crc;        // CRC-32 of the input record
+    uint32_t output_crc;       // CRC-32 of the compressed bytes
+    uint32_t reserved[3];      // Pads the record to 32 bytes, one cache line
+    uint32_t sequence;         // Job index + 1, lets the host tell a fresh record from a previous lap
+} LzwCompletion;
+
+/**
+ * @brief Ring control block in DDR, only ever written by the host.
+ *        Indices are free running from 0 at every start; slot = index & (ring_size - 1).
+ */
+typedef struct {
+    uint32_t tail;         // One past the last submitted job
+    uint32_t stop;         // The core returns once the ring is drained and stop is set
+} LzwRingControl;
 
 /************************** Helper Function Declarations ******************************/
 /**
- * @brief Initializes the dictionary with single-byte entries.
+ * @brief Packs a prefix + extension pair and its code into a dictionary entry.
+ *
+ * @param prefix  The prefix code.
+ * @param ext     The extension byte.
+ * @param code    Assigned code (0 leaves the entry free, e.g. for a lookup key).
+ *
+ * @return        The packed entry.
  */
-void init_dictionary(void);
+Dictionary Dictionary_pack(uint16_t prefix, uint8_t ext, uint16_t code);
+
+/**
+ * @brief Returns the code of a packed entry, 0 if the entry is free.
+ *
+ * @param entry   The packed entry.
+ *
+ * @return        The code stored in the entry.
+ */
+uint16_t Dictionary_code(Dictionary entry);
+
+/**
+ * @brief Reports the BRAM36 blocks taken by the dictionary of one lzw_compress instance
+ *        in the selected layout, epoch tags included (recent-pair cache excluded, it is mapped to registers).
+ *
+ * @return Number of BRAM36 blocks.
+ */
+uint32_t Dictionary_bram36(void);
+
+/**
+ * @brief Mixes prefix and extension into 32 bits with the LZW_HASH_FUNCTION hash, the slots of the
+ *        bucketed and cuckoo layouts (bank 0) and, except for LZW_HASH_SHIFT_XOR, hash1/hash2 are its top bits.
+ *
+ * @param prefix        The prefix code.
+ * @param ext           The extention byte.
+ *
+ * @return 32-bit hash.
+ */
+uint32_t hash_mix(uint16_t prefix, uint8_t ext);
 
 /**
  * @brief Computes a hash from prefix and extension for dictionary indexing.
@@ -39,46 +272,181 @@ uint32_t hash1(uint16_t prefix, uint8_t ext);
 uint32_t hash2(uint16_t prefix, uint8_t ext);
 
 /**
- * @brief Finds the code for a given prefix + extension entry in the dictionary.
+ * @brief Computes the bucket index of a prefix + extension pair (bucketed layout).
+ *
+ * @param prefix        The prefix code.
+ * @param ext           The extention byte.
+ *
+ * @return Bucket index in [0, DICTIONARY_BUCKET_COUNT).
+ */
+uint32_t hash_bucket(uint16_t prefix, uint8_t ext);
+
+/**
+ * @brief Computes the slot of a prefix + extension pair in each cuckoo bank (cuckoo layout).
+ *
+ * @param prefix        The prefix code.
+ * @param ext           The extention byte.
+ *
+ * @return Slot index in [0, DICTIONARY_CUCKOO_SIZE).
+ */
+uint32_t hash_cuckoo0(uint16_t prefix, uint8_t ext);
+uint32_t hash_cuckoo1(uint16_t prefix, uint8_t ext);
+
+/**
+ * @brief Looks a prefix + extension pair up in the recent-pair cache.
+ *
+ * @param prefix  The prefix code.
+ * @param ext     The extension byte.
+ *
+ * @return        The cached code if present, INVALID_CODE otherwise.
+ */
+uint16_t Dictionary_cache_find(uint16_t prefix, uint8_t ext);
+
+/**
+ * @brief Records a prefix + extension pair in the recent-pair cache (round-robin replacement).
+ *
+ * @param prefix  The prefix code.
+ * @param ext     The extension byte.
+ * @param code    Code assigned to the sequence.
+ */
+void Dictionary_cache_insert(uint16_t prefix, uint8_t ext, uint16_t code);
+
+/**
+ * @brief Reports the recent-pair cache statistics gathered during C simulation.
+ *
+ * @param lookups Pointer to store the number of dictionary lookups.
+ * @param hits    Pointer to store the number of lookups served by the cache.
+ */
+void Dictionary_cache_stats(uint32_t *lookups, uint32_t *hits);
+
+/**
+ * @brief Returns the row where a string goes when the table is empty (its first probe slot, bucket or bank 0 slot).
+ *
+ * @param prefix  The prefix code.
+ * @param ext     The extension byte.
+ *
+ * @return        Row index in [0, DICTIONARY_ROWS).
+ */
+uint32_t Dictionary_first_row(uint16_t prefix, uint8_t ext);
+
+/**
+ * @brief Starts a new, empty dictionary by moving to the next epoch (and emptying the cuckoo stash).
+ *
+ * @return        true when the epoch wrapped: the table must then be cleared row by row before it is used.
+ */
+bool Dictionary_new_epoch(void);
+
+/**
+ * @brief Clears one row of the dictionary table (one main loop iteration of a clear).
+ *
+ * @param row           Row to clear.
+ * @param pending_row   Row of the entry whose insert triggered the reset, DICTIONARY_NO_ADDR if none.
+ * @param pending_entry Entry written to the first slot of pending_row.
+ */
+void Dictionary_clear_row(uint32_t row, uint32_t pending_row, Dictionary pending_entry);
+
+/**
+ * @brief Probes one slot of the dictionary table for a prefix + extension pair (one main loop iteration).
+ *        The bucketed and cuckoo layouts compare all their candidates at once and always resolve.
  *
  * @param prefix  The prefix code.
  * @param ext     The extension byte.
+ * @param probe   Position in the probe sequence, 0 for the first probe.
+ * @param slot    Pointer to store the slot (linear), bucket (bucketed) or bank 0 slot (cuckoo) probed.
+ * @param shadow  Probe the duplicated table of the speculative matcher instead of the main one.
  *
- * @return        The code for the sequence if found, INVALID_CODE otherwise.
+ * @return        The code if found, INVALID_CODE if the pair is not in the table,
+ *                DICTIONARY_PROBE_AGAIN if the next probe is needed.
  */
-uint16_t Dictionary_find(uint16_t prefix, uint8_t ext);
+uint16_t Dictionary_probe(uint16_t prefix, uint8_t ext, uint32_t probe, uint32_t *slot, bool shadow);
 
 /**
- * @brief Adds a new prefix + extension to the dictionary.
+ * @brief Inserts an entry after a missed probe, at the slot the probe returned.
  *
- * @param prefix          Prefix code.
- * @param ext             Extension byte.
- * @param dictionary_size Pointer to current dictionary size (updated internally).
- * @param bit_count       Pointer to current code bit width.
+ * @param entry   Packed entry to insert.
+ * @param slot    Slot returned by the last Dictionary_probe.
+ *
+ * @return        true when done, false when a cuckoo displacement is needed (Dictionary_kick).
  */
-void Dictionary_add(uint16_t prefix, uint8_t ext, uint16_t *dictionary_size, uint8_t *bit_count);
+bool Dictionary_insert(Dictionary entry, uint32_t slot);
 
 /**
- * @brief Writes a code into the output buffer using a specific bit width.
+ * @brief Performs one cuckoo displacement (one main loop iteration), stashing or dropping the entry
+ *        after DICTIONARY_CUCKOO_MAX_KICKS kicks.
+ *
+ * @param moving  Pointer to the entry being placed, replaced by the evicted one.
+ * @param addr    Pointer to the table address to place it at, updated to the evicted entry's other slot.
+ * @param kicks   Pointer to the number of displacements so far.
  *
- * @param code       Code to write.
- * @param output     Output buffer.
- * @param bit_count  Current bit width for codes.
- * @param out_index  Pointer to current output bit index.
+ * @return        true once the entry is placed.
  */
-void write_output(uint16_t code, uint8_t *output, uint8_t bit_count, uint32_t *out_index);
+bool Dictionary_kick(Dictionary *moving, uint32_t *addr, uint32_t *kicks);
+
+/**
+ * @brief Adds one byte to a running CRC-32 (start from CRC32_INIT, XOR the result with CRC32_INIT).
+ *
+ * @param crc     Running CRC.
+ * @param byte    Next byte.
+ *
+ * @return Updated running CRC.
+ */
+uint32_t Crc32_update(uint32_t crc, uint8_t byte);
 
 /************************** Main Function Declaration ******************************/
 
 /**
  * @brief LZW compression function for HLS.
  *        Takes an input buffer and writes a compressed output buffer.
+ *        The matcher is a single pipelined state machine (LZW_STATE_*): a byte whose lookup is resolved by the
+ *        recent-pair cache or the first table probe costs one cycle, the table writes still in flight are
+ *        forwarded to the lookups (DICTIONARY_FORWARD_DEPTH), and the codes go through a bit accumulator that
+ *        writes one output byte per cycle.
+ *
+ *        The core cannot see AXI back-pressure, so LZW_PERF_CYCLES only counts the cycles it was busy:
+ *        the host gets the cycles stalled on AXI as the PL cycles elapsed between Start and IsDone
+ *        minus LZW_PERF_CYCLES, and the AXI beat counters tell how many transfers those stalls are spread over.
  *
  * @param input   Pointer to input data buffer.
  * @param output  Pointer to output buffer (bit-packed).
  * @param input_size    Input data size
  * @param compression_size Compression data
+ * @param input_crc     CRC-32 of the input, computed as the bytes are read (0 for an empty input)
+ * @param output_crc    CRC-32 of the compressed bytes, computed as they are written (0 for an empty input)
+ * @param perf_counters Performance counters of the job (LZW_PERF_COUNT words)
+ */
+void lzw_compress(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size,
+                  uint32_t *input_crc, uint32_t *output_crc, uint32_t perf_counters[LZW_PERF_COUNT]);
+
+/**
+ * @brief LZ4 compression function for HLS.
+ *        Writes one LZ4 block (no frame header), decodable at memory speed by any LZ4 decoder.
+ *        The input is read once, in order, and kept in an LZ4_WINDOW_SIZE history that the match table
+ *        candidates are checked and extended against; literals are copied from the input when their
+ *        sequence is written. An empty input gives the one-byte block 0x00 (an empty last sequence),
+ *        since decoders reject a zero-byte block.
+ *
+ * @param input   Pointer to input data buffer.
+ * @param output  Pointer to output buffer (len + len / 255 + 16 bytes, 2 * len + 1 always fits).
+ * @param input_size    Input data size
+ * @param compression_size Compression data
+ * @param input_crc     CRC-32 of the input (0 for an empty input)
+ * @param output_crc    CRC-32 of the LZ4 block, computed as it is written
+ */
+void lz4_compress(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size,
+                  uint32_t *input_crc, uint32_t *output_crc);
+
+/**
+ * @brief Job-ring front end of the LZW compressor for HLS.
+ *        Polls the tail index in the control block, compresses every submitted job back to back and
+ *        writes one completion record per job, so the host never touches the AXI-Lite registers between jobs.
+ *        The flags of each job select the engine (LZW or LZ4).
+ *
+ * @param control      Pointer to the ring control block.
+ * @param jobs         Pointer to the job ring (ring_size descriptors).
+ * @param completions  Pointer to the completion ring (ring_size records).
+ * @param memory       Base of the memory window the job offsets refer to.
+ * @param ring_size    Number of ring slots (power of two).
  */
-void lzw_compress(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size);
+void lzw_compress_ring(volatile LzwRingControl *control, LzwJob *jobs, LzwCompletion *completions, uint8_t *memory, uint32_t ring_size);
 
-#endif
\ No newline at end of file
+#endif
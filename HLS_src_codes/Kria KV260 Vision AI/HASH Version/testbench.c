@@ -1,14 +1,121 @@
 #include "functions.h"
 #include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Minimal LZ4 block decoder, enough to check the blocks written by lz4_compress.
+ *
+ * @return Decompressed size, or -1 if the block is malformed.
+ */
+static int lz4_decode(const uint8_t *src, int src_len, uint8_t *dst, int dst_capacity)
+{
+    int in = 0, out = 0;
+    while (in < src_len) {
+        uint8_t token = src[in++];
+        int length = token >> 4;
+        if (length == 15) {
+            uint8_t more = 255;
+            while (more == 255 && in < src_len) length += (more = src[in++]);
+        }
+        if (in + length > src_len || out + length > dst_capacity) return -1;
+        memcpy(dst + out, src + in, length);
+        in += length;
+        out += length;
+        if (in == src_len) break;
+
+        if (in + 2 > src_len) return -1;
+        int offset = src[in] | (src[in + 1] << 8);
+        in += 2;
+        length = (token & 15) + 4;
+        if ((token & 15) == 15) {
+            uint8_t more = 255;
+            while (more == 255 && in < src_len) length += (more = src[in++]);
+        }
+        if (offset == 0 || offset > out || out + length > dst_capacity) return -1;
+        for (int i = 0; i < length; i++, out++) dst[out] = dst[out - offset];
+    }
+    return out;
+}
+
+/**
+ * @brief Reference CRC-32 of a whole buffer, bit by bit, to check the in-line CRCs of the engines.
+ */
+static uint32_t crc32_reference(const uint8_t *data, uint32_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+    return size ? ~crc : 0;
+}
+
+/**
+ * @brief Compresses a whole file and prints the cycle estimate given by the performance counters.
+ *        The main loop is pipelined at II=1, so its iteration count is the busy cycle count of the core.
+ *
+ * @param path      Corpus file.
+ *
+ * @return 0 on success, 1 if the file cannot be read.
+ */
+static int run_corpus(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("Cannot open %s\n", path);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    int size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t *input = malloc(size + 1);
+    uint8_t *output = calloc(2 * size + 2, 1);
+    if ((int)fread(input, 1, size, file) != size) size = 0;
+    fclose(file);
+
+    uint32_t compression_size = 0;
+    uint32_t input_crc = 0, output_crc = 0;
+    uint32_t perf_counters[LZW_PERF_COUNT] = {0};
+    lzw_compress(input, output, size, &compression_size, &input_crc, &output_crc, perf_counters);
+
+    double bytes = size ? (double)size : 1.0;
+    printf("%s: %d -> %u bytes (%.2f%%)\n", path, size, compression_size, 100.0 * compression_size / bytes);
+    printf("Model: %u busy cycles (%.2f per byte), %.2f probes per byte (max %u), %u resets\n",
+           perf_counters[LZW_PERF_CYCLES], perf_counters[LZW_PERF_CYCLES] / bytes,
+           perf_counters[LZW_PERF_PROBES] / bytes, perf_counters[LZW_PERF_PROBE_MAX], perf_counters[LZW_PERF_RESETS]);
+    printf("Model: %u codes out, AXI %u read beats, %u write beats, %u two-byte cycles\n",
+           perf_counters[LZW_PERF_CODES_OUT], perf_counters[LZW_PERF_AXI_READS], perf_counters[LZW_PERF_AXI_WRITES],
+           perf_counters[LZW_PERF_SPECULATED]);
+
+    int errors = 0;
+    if (input_crc != crc32_reference(input, size) || output_crc != crc32_reference(output, compression_size)) {
+        printf("In-line CRCs do not match the buffers\n");
+        errors = 1;
+    }
+
+    free(input);
+    free(output);
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    // csim -argv "<corpus> ...": cycle estimate on real files instead of the built-in strings.
+    if (argc > 1) {
+        int errors = 0;
+        for (int i = 1; i < argc; i++) errors += run_corpus(argv[i]);
+        return errors;
+    }
 
-int main(void)
-{   
     int size = 9;
     uint8_t input[] = "ABAABAAAB";
     uint8_t output[32] = {0};
     uint32_t compression_size = 0;
+    uint32_t input_crc = 0, output_crc = 0;
+    uint32_t perf_counters[LZW_PERF_COUNT] = {0};
 
-    lzw_compress(input, output, size, &compression_size);
+    lzw_compress(input, output, size, &compression_size, &input_crc, &output_crc, perf_counters);
 
     printf("Compression size = %u\n", compression_size);
 
@@ -16,5 +123,101 @@ int main(void)
         printf("output[%u] = %u\n", i, output[i]);
     }
 
-    return 0;
-}
\ No newline at end of file
+    printf("Perf: %u busy cycles, %u bytes in, %u codes out, %u probes (max %u), %u resets, %u AXI reads, %u AXI writes\n",
+           perf_counters[LZW_PERF_CYCLES], perf_counters[LZW_PERF_BYTES_IN], perf_counters[LZW_PERF_CODES_OUT],
+           perf_counters[LZW_PERF_PROBES], perf_counters[LZW_PERF_PROBE_MAX], perf_counters[LZW_PERF_RESETS],
+           perf_counters[LZW_PERF_AXI_READS], perf_counters[LZW_PERF_AXI_WRITES]);
+    if (LZW_PERF_COUNTERS && (perf_counters[LZW_PERF_BYTES_IN] != (uint32_t)size || perf_counters[LZW_PERF_CODES_OUT] != 6)) {
+        printf("Perf counters do not match the input\n");
+        return 1;
+    }
+
+    printf("CRC-32: input %08x, output %08x\n", input_crc, output_crc);
+    if (input_crc != crc32_reference(input, size) || output_crc != crc32_reference(output, compression_size)) {
+        printf("In-line CRCs do not match the buffers\n");
+        return 1;
+    }
+
+    printf("Dictionary: %u BRAM36 per lzw_compress instance\n", Dictionary_bram36());
+
+    uint32_t cache_lookups = 0, cache_hits = 0;
+    Dictionary_cache_stats(&cache_lookups, &cache_hits);
+    printf("Recent-pair cache: %u hits / %u lookups (%.1f%%)\n", cache_hits, cache_lookups,
+           cache_lookups ? 100.0 * cache_hits / cache_lookups : 0.0);
+
+    // Job ring: four records queued up front, each must match a direct lzw_compress or lz4_compress call.
+    static uint8_t memory[1024] = {0};
+    const char *records[4] = {"ABAABAAAB", "TOBEORNOTTOBEORTOBEORNOT", "AAAAAAAAAAAAAAAAAAAAAAAA",
+                              "GET /index.html 200\nGET /index.html 304\nGET /style.css 200\n"};
+    LzwJob jobs[4] = {{0}};
+    LzwCompletion completions[4] = {{0}};
+    LzwRingControl control = {0};
+    uint32_t offset = 0;
+    int errors = 0;
+
+    for (int i = 0; i < 4; i++) {
+        uint32_t len = strlen(records[i]);
+        memcpy(memory + offset, records[i], len);
+        jobs[i].src = offset;
+        jobs[i].len = len;
+        jobs[i].dst = offset + len;
+        jobs[i].flags = (i == 3) ? LZW_JOB_FLAG_LZ4 : 0;
+        offset += 3 * len;
+    }
+    control.tail = 4;
+    control.stop = 1;
+
+    lzw_compress_ring(&control, jobs, completions, memory, 4);
+
+    for (int i = 0; i < 4; i++) {
+        uint8_t expected[128] = {0};
+        uint32_t expected_size = 0;
+        if (jobs[i].flags == LZW_JOB_FLAG_LZ4) lz4_compress((uint8_t *)records[i], expected, jobs[i].len, &expected_size, &input_crc, &output_crc);
+        else lzw_compress((uint8_t *)records[i], expected, jobs[i].len, &expected_size, &input_crc, &output_crc, perf_counters);
+        if (completions[i].status != LZW_JOB_DONE || completions[i].sequence != (uint32_t)i + 1 ||
+            completions[i].compressed_size != expected_size ||
+            memcmp(memory + jobs[i].dst, expected, expected_size) != 0 ||
+            completions[i].input_crc != crc32_reference((const uint8_t *)records[i], jobs[i].len) ||
+            completions[i].output_crc != crc32_reference(expected, expected_size)) {
+            printf("Ring job %d does not match its engine\n", i);
+            errors++;
+        }
+    }
+    printf("Ring: %d mismatching jobs\n", errors);
+
+    // Epochs: more back-to-back jobs than there are epochs, cycling through records that share pairs under
+    // other codes. Each job must match the first compression of its record, so no slot of an earlier job leaks.
+    uint8_t first[3][128] = {{0}};
+    uint32_t first_sizes[3] = {0};
+    int epoch_errors = 0;
+    for (uint32_t i = 0; i < (2u << DICTIONARY_EPOCH_BITS) + 3; i++) {
+        const char *record = records[i % 3];
+        uint8_t compressed[128] = {0};
+        uint32_t compressed_size = 0;
+        lzw_compress((uint8_t *)record, i < 3 ? first[i] : compressed, strlen(record), i < 3 ? &first_sizes[i] : &compressed_size,
+                     &input_crc, &output_crc, perf_counters);
+        if (i >= 3 && (compressed_size != first_sizes[i % 3] || memcmp(compressed, first[i % 3], compressed_size) != 0)) epoch_errors++;
+    }
+    printf("Epochs: %d mismatching jobs\n", epoch_errors);
+    errors += epoch_errors;
+
+    // LZ4 blocks must decode back to their input.
+    uint8_t decoded[128] = {0};
+    int decoded_size = lz4_decode(memory + jobs[3].dst, completions[3].compressed_size, decoded, sizeof(decoded));
+    printf("LZ4: %u -> %u bytes\n", jobs[3].len, completions[3].compressed_size);
+    if (decoded_size != (int)jobs[3].len || memcmp(decoded, records[3], jobs[3].len) != 0) {
+        printf("LZ4 block does not decode to its input\n");
+        errors++;
+    }
+
+    // An empty input is the token of an empty last sequence, not a zero-byte block.
+    uint32_t empty_size = 0;
+    decoded[0] = 0xFF;
+    lz4_compress(memory, decoded, 0, &empty_size, &input_crc, &output_crc);
+    if (empty_size != 1 || decoded[0] != 0 || input_crc != 0 || output_crc != crc32_reference(decoded, 1)) {
+        printf("Empty LZ4 input does not give the one-byte block\n");
+        errors++;
+    }
+
+    return errors;
+}
@@ -0,0 +1,129 @@
+#include "functions.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * @brief Compresses a whole file split over the engines, as the host application does, and prints the
+ *        cycle model of the run. Used to compare architecture changes on real corpora without synthesis.
+ *
+ * @param path          Corpus file.
+ *
+ * @return 0 on success, 1 if the file cannot be read.
+ */
+static int run_corpus(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("Cannot open %s\n", path);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    uint32_t size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    // Input first, then one word aligned output buffer of 2 * len bytes (rounded up) per engine.
+    LzwDescriptor descriptors[NUMBER_PARALLEL_FUNCTIONS];
+    uint32_t input_words = (size + MEMORY_WORD_BYTES - 1) / MEMORY_WORD_BYTES;
+    uint32_t total_words = input_words;
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        descriptors[i].src = size / NUMBER_PARALLEL_FUNCTIONS * i + (i < (int)(size % NUMBER_PARALLEL_FUNCTIONS) ? i : size % NUMBER_PARALLEL_FUNCTIONS);
+        descriptors[i].len = size / NUMBER_PARALLEL_FUNCTIONS + (i < (int)(size % NUMBER_PARALLEL_FUNCTIONS) ? 1 : 0);
+        descriptors[i].dst = total_words * MEMORY_WORD_BYTES;
+        descriptors[i].size_out = 0;
+        descriptors[i].cycles = 0;
+        total_words += (2 * descriptors[i].len + MEMORY_WORD_BYTES - 1) / MEMORY_WORD_BYTES + 1;
+    }
+
+    uint8_t *bytes = (uint8_t *)malloc(size + 1);
+    MemoryWord *memory = new MemoryWord[total_words];
+    if (fread(bytes, 1, size, file) != size) size = 0;
+    fclose(file);
+    for (uint32_t i = 0; i < total_words; i++) memory[i] = 0;
+    for (uint32_t i = 0; i < size; i++) {
+        memory[i / MEMORY_WORD_BYTES].range(8 * (i % MEMORY_WORD_BYTES) + 7, 8 * (i % MEMORY_WORD_BYTES)) = bytes[i];
+    }
+
+    Model_reset();
+    top_parallel_lzw(descriptors, memory, memory);
+
+    uint64_t compressed = 0;
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) compressed += descriptors[i].size_out;
+    printf("%s: %u -> %llu bytes (%.2f%%)\n", path, size, (unsigned long long)compressed,
+           size ? 100.0 * compressed / size : 0.0);
+    Model_print(Model_get());
+
+    delete[] memory;
+    free(bytes);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    // csim -argv "<corpus> ...": cycle model on real files instead of the built-in string.
+    if (argc > 1) {
+        int errors = 0;
+        for (int i = 1; i < argc; i++) errors += run_corpus(argv[i]);
+        return errors;
+    }
+
+
+    int size = 30;
+    uint8_t input[] = "ABAABAABAABAABAABAABAABAABAABA";
+    static MemoryWord memory[MEMORY_DEPTH] = {0};
+    LzwDescriptor descriptors[NUMBER_PARALLEL_FUNCTIONS];
+
+    int part_size = size / NUMBER_PARALLEL_FUNCTIONS;
+    int remainder = size % NUMBER_PARALLEL_FUNCTIONS;
+    int sizes[NUMBER_PARALLEL_FUNCTIONS];
+    int offsets[NUMBER_PARALLEL_FUNCTIONS];
+
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        sizes[i] = part_size + (i < remainder ? 1 : 0);
+        offsets[i] = (i == 0) ? 0 : offsets[i-1] + sizes[i-1];
+    }
+
+    // Input at the start of the memory window, one output buffer of 32 bytes per engine after it.
+    for (int i = 0; i < size; i++) {
+        memory[i / MEMORY_WORD_BYTES].range(8 * (i % MEMORY_WORD_BYTES) + 7, 8 * (i % MEMORY_WORD_BYTES)) = input[i];
+    }
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        descriptors[i].src = offsets[i];
+        descriptors[i].len = sizes[i];
+        descriptors[i].dst = 1024 + 32 * i;
+        descriptors[i].size_out = 0;
+        descriptors[i].cycles = 0;
+    }
+
+    top_parallel_lzw(descriptors, memory, memory);
+
+    uint32_t uram_per_engine = uram_count(LZW_HASH_SIZE, LZW_ENTRY_BITS);
+    uint32_t bram36_per_engine = bram36_count(LZW_HASH_SIZE, LZW_ENTRY_BITS);
+    printf("Dictionary: %d x %d bits = %u URAM or %u BRAM36 per engine, %u URAM for %d engines\n",
+           LZW_HASH_SIZE, LZW_ENTRY_BITS, uram_per_engine, bram36_per_engine,
+           uram_per_engine * NUMBER_PARALLEL_FUNCTIONS, NUMBER_PARALLEL_FUNCTIONS);
+    uint32_t blocks_per_engine = 2 * (bram36_count(LZW_IN_BLOCK_WORDS, MEMORY_WORD_BITS) +
+                                      bram36_count(LZW_OUT_BLOCK_WORDS, MEMORY_WORD_BITS));
+    printf("Burst blocks (ping and pong): 2 x (%d + %d words of %d bits) = %u BRAM36 per engine\n",
+           LZW_IN_BLOCK_WORDS, LZW_OUT_BLOCK_WORDS, MEMORY_WORD_BITS, blocks_per_engine);
+    printf("BRAM36: %u of burst blocks for %d engines (K26: 144)\n",
+           blocks_per_engine * NUMBER_PARALLEL_FUNCTIONS, NUMBER_PARALLEL_FUNCTIONS);
+
+    printf("\n");
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; ++i) {
+        printf("Compression_size[%d] = %u (%u busy cycles)\n", i + 1, descriptors[i].size_out, descriptors[i].cycles);
+    }
+    printf("\n");
+
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; ++i) {
+        printf("Output of %dth lzw_compress:\n", i + 1);
+        for (uint32_t j = 0; j < descriptors[i].size_out; ++j) {
+            uint32_t addr = descriptors[i].dst + j;
+            uint32_t byte = memory[addr / MEMORY_WORD_BYTES].range(8 * (addr % MEMORY_WORD_BYTES) + 7, 8 * (addr % MEMORY_WORD_BYTES));
+            printf("output%d[%u] = %u\n", i + 1, j, byte);
+        }
+        printf("----------------------------------------------------------------\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "functions.h"
+
+/**************************  Global Variables Declarations ******************************/
+static uint16_t decode_prefix[MAX_DICTIONARY_SIZE];    // Prefix code of every entry >= 256
+static uint8_t decode_last[MAX_DICTIONARY_SIZE];       // Last byte of every entry >= 256
+static uint8_t decode_stack[MAX_DICTIONARY_SIZE];      // String bytes in reverse order
+
+/**************************  Helper Functions Declarations ******************************/
+void Decoder_reset(uint16_t *dictionary_size, uint8_t *bit_count) {
+    #pragma HLS INLINE off
+    // The tables are not cleared: a valid stream only references codes below dictionary_size,
+    // and each of those is rewritten after the reset before it can be used.
+    (*dictionary_size) = 256;
+    (*bit_count) = 8;
+}
+
+uint16_t read_input(uint8_t *input, uint32_t input_size, uint8_t bit_count, uint32_t *in_index) {
+    #pragma HLS INLINE off
+    uint32_t idx = *in_index;
+    uint32_t byte_index = idx / 8;
+    uint32_t bit_offset = idx % 8;
+
+    // A code of up to 12 bits spans at most 3 bytes.
+    uint32_t window = 0;
+    for (uint32_t i = 0; i < 3; i++) {
+        #pragma HLS PIPELINE II=1
+        uint8_t byte = (byte_index + i < input_size) ? input[byte_index + i] : 0;
+        window = (window << 8) | byte;
+    }
+
+    *in_index += bit_count;
+    return (window >> (24 - bit_offset - bit_count)) & ((1u << bit_count) - 1);
+}
+
+uint8_t Decoder_emit(uint16_t code, uint16_t pending, uint8_t *output, uint32_t output_capacity, uint32_t *out_index) {
+    #pragma HLS INLINE off
+    uint32_t depth = 0;
+    uint32_t pending_pos = MAX_DICTIONARY_SIZE;
+
+    while (code >= 256 && depth < MAX_DICTIONARY_SIZE - 1) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT max=MAX_DICTIONARY_SIZE
+        if (code == pending) pending_pos = depth;
+        decode_stack[depth++] = decode_last[code];
+        code = decode_prefix[code];
+    }
+
+    uint8_t first = code;
+    decode_stack[depth++] = first;
+    if (pending_pos != MAX_DICTIONARY_SIZE) decode_stack[pending_pos] = first;
+
+    uint32_t idx = *out_index;
+    for (uint32_t i = depth; i > 0; i--) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT max=MAX_DICTIONARY_SIZE
+        if (idx < output_capacity) output[idx] = decode_stack[i - 1];
+        idx++;
+    }
+    *out_index = idx;
+
+    return first;
+}
+
+/**************************  Main Function Declaration ******************************/
+void lzw_decompress(uint8_t *input, uint8_t *output, int input_size, int output_capacity,
+                    uint32_t *decompression_size, uint32_t *status){
+    #pragma HLS INTERFACE m_axi depth=input_size port=input offset=slave bundle=AXIM_A
+    #pragma HLS INTERFACE m_axi depth=output_capacity port=output offset=slave bundle=AXIM_A
+    #pragma HLS INTERFACE s_axilite port=input   bundle=control
+    #pragma HLS INTERFACE s_axilite port=output  bundle=control
+    #pragma HLS INTERFACE s_axilite port=return  bundle=control
+    #pragma HLS INTERFACE s_axilite port=input_size    bundle=control
+    #pragma HLS INTERFACE s_axilite port=output_capacity    bundle=control
+    #pragma HLS INTERFACE s_axilite port=decompression_size bundle=control
+    #pragma HLS INTERFACE s_axilite port=status    bundle=control
+
+    uint16_t dictionary_size = 256;
+    uint8_t bit_count = 8;
+    uint32_t in_index = 0;
+    uint32_t out_index = 0;
+    uint32_t total_bits = (uint32_t)input_size * 8;
+    uint32_t capacity = (uint32_t)output_capacity;
+
+    *status = LZW_DECOMPRESS_OK;
+    if (total_bits < 8) {
+        *decompression_size = 0;
+        return;
+    }
+    if (capacity == 0) {
+        *decompression_size = 0;
+        *status = LZW_DECOMPRESS_OVERFLOW;
+        return;
+    }
+
+    // The first code is 8 bits wide, always a root.
+    uint16_t prev = read_input(input, input_size, bit_count, &in_index);
+    output[out_index++] = prev;
+
+    // Before every code the compressor has run Dictionary_add for the previous one: replay its
+    // reset and width update, then read. Padding is always shorter than the current code width.
+    while (1) {
+        if (dictionary_size >= MAX_DICTIONARY_SIZE) Decoder_reset(&dictionary_size, &bit_count);
+        if (dictionary_size >= (1u << bit_count)) bit_count++;
+        if (total_bits - in_index < bit_count) break;
+
+        uint16_t code = read_input(input, input_size, bit_count, &in_index);
+        uint16_t pending = dictionary_size;
+
+        // Only the entry being built may be referenced ahead of time (KwKwK).
+        if (code > pending) {
+            *status = LZW_DECOMPRESS_BAD_CODE;
+            break;
+        }
+
+        decode_prefix[pending] = prev;
+        decode_last[pending] = Decoder_emit(code, pending, output, capacity, &out_index);
+        if (out_index > capacity) {
+            out_index = capacity;
+            *status = LZW_DECOMPRESS_OVERFLOW;
+            break;
+        }
+        dictionary_size++;
+        prev = code;
+    }
+
+    *decompression_size = out_index;
+}
@@ -0,0 +1,74 @@
+#ifndef DECOMPRESSION_FUNCTION_H
+#define DECOMPRESSION_FUNCTION_H
+
+/************************** Include Files ******************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/************************** Constant Definitions ******************************/
+#define MAX_DICTIONARY_SIZE  4096           // Maximum size of the LZW dictionary (12-bit codes)
+
+// Values of the status register
+#define LZW_DECOMPRESS_OK          0        // Stream decoded
+#define LZW_DECOMPRESS_BAD_CODE    1        // Code above the next dictionary entry: corrupt stream
+#define LZW_DECOMPRESS_OVERFLOW    2        // Decoded data larger than output_capacity
+
+/************************** Helper Function Declarations ******************************/
+/**
+ * @brief Resets the decoder dictionary state, mirroring Dictionary_reset in the compressor.
+ *
+ * @param dictionary_size Pointer to current dictionary size.
+ * @param bit_count       Pointer to current code bit width.
+ */
+void Decoder_reset(uint16_t *dictionary_size, uint8_t *bit_count);
+
+/**
+ * @brief Reads the next code from the bit-packed input buffer.
+ *
+ * @param input       Input buffer (bit-packed codes, MSB first).
+ * @param input_size  Input data size in bytes.
+ * @param bit_count   Current bit width for codes.
+ * @param in_index    Pointer to current input bit index (advanced by bit_count).
+ *
+ * @return The code read.
+ */
+uint16_t read_input(uint8_t *input, uint32_t input_size, uint8_t bit_count, uint32_t *in_index);
+
+/**
+ * @brief Expands a code into the output buffer.
+ *        The string is built backwards on the reverse stack by following the prefix table, then popped
+ *        into the output. The last byte of the pending entry is unknown until the walk reaches the first
+ *        byte, so its stack position is patched afterwards (covers the KwKwK case).
+ *        Bytes at or past output_capacity are not written, but out_index still counts them.
+ *
+ * @param code             Code to expand.
+ * @param pending          Code of the entry being built (its prefix is already set).
+ * @param output           Output buffer.
+ * @param output_capacity  Output buffer size in bytes.
+ * @param out_index        Pointer to current output byte index.
+ *
+ * @return First byte of the expanded string.
+ */
+uint8_t Decoder_emit(uint16_t code, uint16_t pending, uint8_t *output, uint32_t output_capacity, uint32_t *out_index);
+
+/************************** Main Function Declaration ******************************/
+
+/**
+ * @brief LZW decompression function for HLS.
+ *        Decodes a stream produced by lzw_compress (same code-width growth and reset points).
+ *        Decoding stops at the first code that is not yet in the dictionary, and before any write
+ *        past output_capacity; the bytes decoded up to that point are kept.
+ *
+ * @param input               Pointer to compressed data buffer.
+ * @param output              Pointer to output buffer.
+ * @param input_size          Compressed data size.
+ * @param output_capacity     Output buffer size in bytes.
+ * @param decompression_size  Pointer to store decompressed data size (in bytes, at most output_capacity).
+ * @param status              Pointer to store LZW_DECOMPRESS_OK, LZW_DECOMPRESS_BAD_CODE or LZW_DECOMPRESS_OVERFLOW.
+ */
+void lzw_decompress(uint8_t *input, uint8_t *output, int input_size, int output_capacity,
+                    uint32_t *decompression_size, uint32_t *status);
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Round-trip testbench: every input is compressed with the hash core (add
+ * "../HASH Version/functions.c" to the testbench files) and decompressed with lzw_decompress.
+ */
+#include "functions.h"
+#include "../HASH Version/functions.h"
+#include <stdio.h>
+
+#define TEST_SIZE 100000
+
+static uint8_t input[TEST_SIZE];
+static uint8_t compressed[2 * TEST_SIZE];
+static uint8_t decompressed[TEST_SIZE];
+
+static int round_trip(const char *name, uint8_t *data, int size)
+{
+    uint32_t compression_size = 0;
+    uint32_t decompression_size = 0;
+    uint32_t status = 0;
+    uint32_t input_crc = 0, output_crc = 0;
+    uint32_t perf_counters[LZW_PERF_COUNT];
+
+    memset(compressed, 0, sizeof(compressed));
+    lzw_compress(data, compressed, size, &compression_size, &input_crc, &output_crc, perf_counters);
+    lzw_decompress(compressed, decompressed, compression_size, TEST_SIZE, &decompression_size, &status);
+
+    int ok = (status == LZW_DECOMPRESS_OK) && (decompression_size == (uint32_t)size) &&
+             memcmp(data, decompressed, size) == 0;
+    printf("%-12s %6d bytes -> %6u compressed -> %6u decompressed: %s\n",
+           name, size, compression_size, decompression_size, ok ? "OK" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+/*
+ * Decodes a damaged stream (already in compressed[]) into a buffer of the given capacity, followed by
+ * a guard byte. The decoder must report the expected status, keep to the capacity, and what it did
+ * decode must be a prefix of the original data.
+ */
+static int damaged(const char *name, uint8_t *data, int size, int stream_size, int capacity, uint32_t expected)
+{
+    uint32_t decompression_size = 0;
+    uint32_t status = LZW_DECOMPRESS_OK;
+
+    memset(decompressed, 0xAA, sizeof(decompressed));
+    lzw_decompress(compressed, decompressed, stream_size, capacity, &decompression_size, &status);
+
+    int ok = (status == expected) && decompression_size <= (uint32_t)capacity &&
+             decompressed[capacity] == 0xAA && decompression_size <= (uint32_t)size &&
+             memcmp(data, decompressed, decompression_size) == 0;
+    printf("%-12s %6d bytes stream, capacity %6d -> %6u decompressed, status %u: %s\n",
+           name, stream_size, capacity, decompression_size, status, ok ? "OK" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+int main(void)
+{
+    int errors = 0;
+    uint32_t seed = 1;
+
+    errors += round_trip("empty", input, 0);
+
+    memcpy(input, "A", 1);
+    errors += round_trip("single", input, 1);
+
+    memcpy(input, "ABAABAAAB", 9);
+    errors += round_trip("ABAABAAAB", input, 9);
+
+    memcpy(input, "TOBEORNOTTOBEORTOBEORNOT", 24);
+    errors += round_trip("tobeornot", input, 24);
+
+    // Long runs exercise the KwKwK case
+    for (int i = 0; i < TEST_SIZE; i++) input[i] = 'A' + (i / 5000);
+    errors += round_trip("runs", input, TEST_SIZE);
+
+    // Random bytes fill the dictionary quickly and exercise Dictionary_reset
+    for (int i = 0; i < TEST_SIZE; i++) {
+        seed = seed * 1103515245u + 12345u;
+        input[i] = seed >> 16;
+    }
+    errors += round_trip("random", input, TEST_SIZE);
+
+    // Text-like data
+    const char *words[] = {"lorem ", "ipsum ", "dolor ", "sit ", "amet, ", "consectetur\n"};
+    for (int i = 0, w = 0; i < TEST_SIZE; w++) {
+        seed = seed * 1103515245u + 12345u;
+        const char *word = words[(seed >> 16) % 6];
+        for (int j = 0; word[j] && i < TEST_SIZE; j++) input[i++] = word[j];
+    }
+    errors += round_trip("text", input, TEST_SIZE);
+
+    // Same stream, cut in half: decodes to a prefix of the text
+    uint32_t compression_size = 0;
+    uint32_t input_crc = 0, output_crc = 0;
+    uint32_t perf_counters[LZW_PERF_COUNT];
+    lzw_compress(input, compressed, TEST_SIZE, &compression_size, &input_crc, &output_crc, perf_counters);
+    errors += damaged("truncated", input, TEST_SIZE, compression_size / 2, TEST_SIZE - 1, LZW_DECOMPRESS_OK);
+
+    // Whole stream into a buffer too small for it
+    errors += damaged("overflow", input, TEST_SIZE, compression_size, TEST_SIZE / 2, LZW_DECOMPRESS_OVERFLOW);
+
+    // 'A', then the 9-bit code 511 while the next free entry is 256
+    const uint8_t corrupt[] = {0x41, 0xFF, 0x80};
+    memcpy(compressed, corrupt, sizeof(corrupt));
+    errors += damaged("corrupt", (uint8_t *)"A", 1, sizeof(corrupt), TEST_SIZE - 1, LZW_DECOMPRESS_BAD_CODE);
+
+    printf("%d failing cases\n", errors);
+    return errors;
+}
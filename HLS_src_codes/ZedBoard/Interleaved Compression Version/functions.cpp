@@ -0,0 +1,402 @@
+#include "functions.h"
+#ifndef __SYNTHESIS__
+#include <stdio.h>
+
+static LzwInterleaveModel lzw_model;
+#define LZW_MODEL_ADD(field, value) (lzw_model.field += (value))
+#else
+#define LZW_MODEL_ADD(field, value)
+#endif
+
+/**************************  Helper Functions Declarations ******************************/
+uint32_t hash_mix(uint32_t prefix, uint32_t ext) {
+    #pragma HLS INLINE
+    uint32_t key = (ext << LZW_CODE_BITS) | prefix;
+#if LZW_HASH_FUNCTION == LZW_HASH_CRC
+    // One step of the reflected CRC register per key bit, unrolled into an XOR tree.
+    for (int i = 0; i < LZW_CODE_BITS + 8; i++) {
+        #pragma HLS UNROLL
+        key = (key >> 1) ^ (CRC32_POLY & (0u - (key & 1)));
+    }
+    return key;
+#else
+    return key * 2654435761u;
+#endif
+}
+
+uint32_t hash1(uint32_t prefix, uint32_t ext) {
+    #pragma HLS INLINE
+#if LZW_HASH_FUNCTION == LZW_HASH_SHIFT_XOR
+    return ((prefix << 8) ^ ext) & (LZW_HASH_SIZE - 1);
+#else
+    return hash_mix(prefix, ext) >> (32 - LZW_HASH_BITS);
+#endif
+}
+
+uint32_t hash2(uint32_t prefix, uint32_t ext) {
+    #pragma HLS INLINE
+#if LZW_HASH_FUNCTION == LZW_HASH_SHIFT_XOR
+    return (((prefix << 5) ^ (ext * 7)) & (LZW_HASH_SIZE - 1)) | 1;
+#else
+    return ((hash_mix(prefix, ext) >> 8) & (LZW_HASH_SIZE - 1)) | 1;
+#endif
+}
+
+Dictionary Dictionary_pack(ap_uint<LZW_CODE_BITS> prefix, ap_uint<8> ext, ap_uint<LZW_CODE_BITS> code, ap_uint<LZW_EPOCH_BITS> epoch) {
+    #pragma HLS INLINE
+    return (epoch, code, ext, prefix);
+}
+
+void Context_init(LzwContext &context, const LzwDescriptor &job, ap_uint<LZW_EPOCH_BITS> epoch) {
+    #pragma HLS INLINE
+    // A job starts on a new epoch, only the wrap to 0 clears the dictionary first; an empty job has nothing to do at all.
+    context.state = (job.len == 0) ? CONTEXT_DONE : (epoch == 0) ? CONTEXT_CLEAR : CONTEXT_START;
+    context.len = job.len;
+    context.pos = 0;
+    context.out_bits = 0;
+    context.out_words = 0;
+    context.acc = 0;
+    context.pending_bits = 0;
+    context.prefix = 0;
+    context.ext = 0;
+    context.dictionary_size = 256;
+    context.bit_count = 8;
+    context.epoch = epoch;
+    context.h1 = 0;
+    context.h2 = 0;
+    context.slot = 0;
+    context.clear_idx = 0;
+    context.pending_slot = 0;
+    context.pending_entry = 0;
+}
+
+ap_uint<8> Context_next_byte(LzwContext &context, ap_uint<32> block[LZW_BLOCK_WORDS]) {
+    #pragma HLS INLINE
+    uint32_t offset = context.pos % LZW_BLOCK_SIZE;
+    context.pos++;
+    return block[offset / 4] >> (8 * (offset % 4));
+}
+
+void Context_emit(LzwContext &context, ap_uint<LZW_CODE_BITS> code) {
+    #pragma HLS INLINE
+    context.acc = (context.acc << context.bit_count) | code;
+    context.pending_bits += context.bit_count;
+    context.out_bits += context.bit_count;
+}
+
+uint32_t stream_word(uint32_t bits) {
+    #pragma HLS INLINE
+    return (bits >> 24) | ((bits >> 8) & 0xFF00) | ((bits << 8) & 0xFF0000) | (bits << 24);
+}
+
+/**************************  Round Functions Declarations ******************************/
+void Round_read(ap_uint<32> *memory, LzwDescriptor jobs[LZW_CONTEXTS], uint32_t consumed[LZW_CONTEXTS],
+                ap_uint<32> blocks[LZW_CONTEXTS][LZW_BLOCK_WORDS]) {
+    #pragma HLS INLINE off
+    for (int i = 0; i < LZW_CONTEXTS; i++) {
+        uint32_t left = jobs[i].len - consumed[i];
+        uint32_t count = (left < LZW_BLOCK_SIZE) ? left : LZW_BLOCK_SIZE;
+        ap_uint<32> *base = memory + (jobs[i].src + consumed[i]) / 4;
+        if (count > 0) {
+            LZW_MODEL_ADD(read_bursts, 1);
+            LZW_MODEL_ADD(read_beats, (count + 3) / 4);
+        }
+        for (uint32_t w = 0; w < (count + 3) / 4; w++) {
+            #pragma HLS PIPELINE II=1
+            #pragma HLS LOOP_TRIPCOUNT max=LZW_BLOCK_WORDS
+            blocks[i][w] = base[w];
+        }
+        consumed[i] += count;
+        LZW_MODEL_ADD(bytes, count);
+    }
+}
+
+void Round_write(ap_uint<32> *memory, uint32_t offsets[LZW_CONTEXTS], uint32_t words[LZW_CONTEXTS],
+                 ap_uint<32> blocks[LZW_CONTEXTS][LZW_OUT_BLOCK_WORDS]) {
+    #pragma HLS INLINE off
+    for (int i = 0; i < LZW_CONTEXTS; i++) {
+        ap_uint<32> *base = memory + offsets[i];
+        if (words[i] > 0) {
+            LZW_MODEL_ADD(write_bursts, 1);
+            LZW_MODEL_ADD(write_beats, words[i]);
+        }
+        for (uint32_t w = 0; w < words[i]; w++) {
+            #pragma HLS PIPELINE II=1
+            #pragma HLS LOOP_TRIPCOUNT max=LZW_OUT_BLOCK_WORDS
+            base[w] = blocks[i][w];
+        }
+    }
+}
+
+/**************************  Main Function Declaration ******************************/
+void lzw_interleave(LzwContext contexts[LZW_CONTEXTS], ap_uint<32> in_blocks[LZW_CONTEXTS][LZW_BLOCK_WORDS],
+                    ap_uint<32> out_blocks[LZW_CONTEXTS][LZW_OUT_BLOCK_WORDS], uint32_t limit) {
+    #pragma HLS INLINE off
+    // Kept across rounds and calls: the epochs tell the generations apart.
+    static Dictionary dictionary[LZW_CONTEXTS][LZW_HASH_SIZE];
+    #pragma HLS BIND_STORAGE variable=dictionary type=ram_2p impl=bram
+    #pragma HLS BIND_STORAGE variable=contexts type=ram_2p impl=lutram
+
+    // The contexts waiting for this round's block resume; the round runs until none is left working.
+    uint32_t idle = 0;
+    for (int c = 0; c < LZW_CONTEXTS; c++) {
+        #pragma HLS PIPELINE II=1
+        LzwContext context = contexts[c];
+        if (context.state == CONTEXT_WAIT) context.state = CONTEXT_LOOKUP;
+        if (context.state == CONTEXT_DONE) idle++;
+        context.out_words = 0;
+        contexts[c] = context;
+    }
+
+    for (uint32_t c = 0; idle < LZW_CONTEXTS; c = (c == LZW_CONTEXTS - 1) ? 0 : c + 1) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS DEPENDENCE variable=dictionary inter distance=LZW_CONTEXTS true
+        #pragma HLS DEPENDENCE variable=contexts inter distance=LZW_CONTEXTS true
+        LzwContext context = contexts[c];
+        LZW_MODEL_ADD(visits, 1);
+
+        // At most one output word per visit, drained before this visit emits anything:
+        // the accumulator never holds more than 31 + LZW_CODE_BITS bits.
+        bool write_word = false;
+        uint32_t out_word = 0;
+        if (context.pending_bits >= 32) {
+            out_word = stream_word((uint32_t)(context.acc >> (context.pending_bits - 32)));
+            context.pending_bits -= 32;
+            write_word = true;
+        }
+
+        bool probe = false;
+        switch (context.state) {
+        case CONTEXT_CLEAR:
+            LZW_MODEL_ADD(clear_visits, 1);
+            dictionary[c][context.clear_idx] = (context.clear_idx == context.pending_slot) ? context.pending_entry : Dictionary(0);
+            if (context.clear_idx == LZW_HASH_SIZE - 1) context.state = (context.pos == 0) ? CONTEXT_START : CONTEXT_LOOKUP;
+            context.clear_idx++;
+            break;
+        case CONTEXT_START:
+            LZW_MODEL_ADD(byte_visits, 1);
+            context.prefix = Context_next_byte(context, in_blocks[c]);
+            context.state = CONTEXT_LOOKUP;
+            break;
+        case CONTEXT_LOOKUP:
+            if (context.pos == context.len) {
+                Context_emit(context, context.prefix);
+                context.state = CONTEXT_FLUSH;
+                break;
+            }
+            if (context.pos == limit) {
+                LZW_MODEL_ADD(idle_visits, 1);
+                context.state = CONTEXT_WAIT;
+                idle++;
+                break;
+            }
+            LZW_MODEL_ADD(byte_visits, 1);
+            context.ext = Context_next_byte(context, in_blocks[c]);
+            context.h1 = hash1(context.prefix, context.ext);
+            context.h2 = hash2(context.prefix, context.ext);
+            context.slot = context.h1;
+            probe = true;
+            break;
+        case CONTEXT_PROBE:
+            LZW_MODEL_ADD(probe_visits, 1);
+            probe = true;
+            break;
+        case CONTEXT_FLUSH:
+            if (!write_word && context.pending_bits > 0) {
+                // Last partial word, zero padded like lzw_compress pads its last byte.
+                out_word = stream_word((uint32_t)(context.acc << (32 - context.pending_bits)));
+                context.pending_bits = 0;
+                write_word = true;
+            }
+            if (context.pending_bits == 0) {
+                context.state = CONTEXT_DONE;
+                idle++;
+            }
+            break;
+        default:
+            LZW_MODEL_ADD(idle_visits, 1);
+            break;
+        }
+
+        if (probe) {
+            Dictionary entry = dictionary[c][context.slot];
+            ap_uint<LZW_CODE_BITS> code = entry.range(2 * LZW_CODE_BITS + 7, LZW_CODE_BITS + 8);
+            ap_uint<LZW_EPOCH_BITS> epoch = entry.range(LZW_ENTRY_BITS - 1, 2 * LZW_CODE_BITS + 8);
+            ap_uint<LZW_CODE_BITS + 8> key = (context.ext, context.prefix);
+
+            if (code == 0 || epoch != context.epoch) {
+                // Miss: the probe stopped on the slot the new string goes to.
+                Context_emit(context, context.prefix);
+                bool reset = false;
+                if (context.dictionary_size >= LZW_DICTIONARY_SIZE) {
+                    context.dictionary_size = 256;
+                    context.bit_count = 8;
+                    context.epoch++;
+                    reset = true;
+                    LZW_MODEL_ADD(resets, 1);
+                }
+                if (context.dictionary_size >= (1u << context.bit_count)) context.bit_count++;
+                Dictionary added = Dictionary_pack(context.prefix, context.ext, context.dictionary_size, context.epoch);
+                context.dictionary_size++;
+                if (reset && context.epoch == 0) {
+                    // The table is empty after the clear, so the string lands on its first probe slot.
+                    context.pending_entry = added;
+                    context.pending_slot = context.h1;
+                    context.clear_idx = 0;
+                    context.state = CONTEXT_CLEAR;
+                } else {
+                    // Likewise the first slot is free in a new epoch.
+                    dictionary[c][reset ? context.h1 : context.slot] = added;
+                    context.state = CONTEXT_LOOKUP;
+                }
+                context.prefix = context.ext;
+            } else if (entry.range(LZW_CODE_BITS + 7, 0) == key) {
+                context.prefix = code;
+                context.state = CONTEXT_LOOKUP;
+            } else {
+                context.slot += context.h2;
+                context.state = CONTEXT_PROBE;
+            }
+        }
+
+        if (write_word) {
+            out_blocks[c][context.out_words] = out_word;
+            context.out_words++;
+        }
+        contexts[c] = context;
+    }
+}
+
+#ifndef __SYNTHESIS__
+/*
+ * Cycle model of one round: the engine loop runs concurrently with the bursts, which share the memory
+ * port, so only the burst time beyond the engine is on the critical path.
+ */
+static void Model_round(const LzwInterleaveModel &before, uint64_t engine) {
+    uint64_t bursts = (lzw_model.read_bursts - before.read_bursts + lzw_model.write_bursts - before.write_bursts) * LZW_MODEL_AXI_LATENCY
+                    + lzw_model.read_beats - before.read_beats + lzw_model.write_beats - before.write_beats;
+    lzw_model.compute_cycles += engine;
+    lzw_model.burst_cycles += (bursts > engine) ? bursts - engine : 0;
+}
+#endif
+
+/**************************  Top Function Declaration ******************************/
+void top_interleaved_lzw(LzwDescriptor *descriptors, ap_uint<32> *memory) {
+    #pragma HLS INTERFACE m_axi depth=LZW_CONTEXTS port=descriptors offset=slave bundle=AXIM_DESC
+    #pragma HLS INTERFACE m_axi depth=MEMORY_DEPTH port=memory offset=slave bundle=AXIM_MEM max_read_burst_length=256 max_write_burst_length=256
+
+    #pragma HLS INTERFACE s_axilite port=descriptors bundle=control
+    #pragma HLS INTERFACE s_axilite port=memory      bundle=control
+    #pragma HLS INTERFACE s_axilite port=return      bundle=control
+
+    // Last epoch of each context. Like the dictionary it starts at 0 from the bitstream and is not touched
+    // by ap_rst, so the first job finds every slot free on epoch 1 without a clear.
+    static ap_uint<LZW_EPOCH_BITS> epochs[LZW_CONTEXTS];
+    LzwDescriptor jobs[LZW_CONTEXTS];
+    LzwContext contexts[LZW_CONTEXTS];
+    uint32_t consumed[LZW_CONTEXTS];       // Input bytes already read
+    uint32_t written[LZW_CONTEXTS];        // Output words already retired
+    uint32_t write_offsets[LZW_CONTEXTS];  // Burst of the previous round, written during this one
+    uint32_t write_words[LZW_CONTEXTS];
+    #pragma HLS ARRAY_PARTITION variable=jobs complete
+    #pragma HLS ARRAY_PARTITION variable=consumed complete
+    #pragma HLS ARRAY_PARTITION variable=written complete
+    #pragma HLS ARRAY_PARTITION variable=write_offsets complete
+    #pragma HLS ARRAY_PARTITION variable=write_words complete
+
+    // Two pairs of staging blocks, one row per context. While the engine works on the ping blocks, the
+    // next round is read into the pong input blocks and the previous round is written from the pong
+    // output blocks, then the roles swap. Whole words, so each block is one plain memory.
+    ap_uint<32> in_ping[LZW_CONTEXTS][LZW_BLOCK_WORDS];
+    ap_uint<32> in_pong[LZW_CONTEXTS][LZW_BLOCK_WORDS];
+    ap_uint<32> out_ping[LZW_CONTEXTS][LZW_OUT_BLOCK_WORDS];
+    ap_uint<32> out_pong[LZW_CONTEXTS][LZW_OUT_BLOCK_WORDS];
+
+    for (int i = 0; i < LZW_CONTEXTS; i++) {
+        #pragma HLS PIPELINE II=1
+        jobs[i] = descriptors[i];
+        Context_init(contexts[i], jobs[i], epochs[i] + 1);
+        consumed[i] = 0;
+        written[i] = 0;
+        write_words[i] = 0;
+    }
+
+    // The first blocks are read before the engine can start.
+#ifndef __SYNTHESIS__
+    LzwInterleaveModel before = lzw_model;
+#endif
+    Round_read(memory, jobs, consumed, in_ping);
+#ifndef __SYNTHESIS__
+    Model_round(before, 0);
+#endif
+
+    bool busy = true;
+    for (uint32_t round = 0; busy; round++) {
+        #pragma HLS LOOP_TRIPCOUNT max=MEMORY_DEPTH*4/LZW_BLOCK_SIZE+1
+        uint32_t limit = (round + 1) * LZW_BLOCK_SIZE;
+#ifndef __SYNTHESIS__
+        before = lzw_model;
+#endif
+        // The three calls touch disjoint blocks, so they are scheduled concurrently.
+        if (round % 2 == 0) {
+            Round_read(memory, jobs, consumed, in_pong);
+            lzw_interleave(contexts, in_ping, out_ping, limit);
+            Round_write(memory, write_offsets, write_words, out_pong);
+        } else {
+            Round_read(memory, jobs, consumed, in_ping);
+            lzw_interleave(contexts, in_pong, out_pong, limit);
+            Round_write(memory, write_offsets, write_words, out_ping);
+        }
+#ifndef __SYNTHESIS__
+        // Visits, the resume pass and the pipeline fill of the engine loop.
+        Model_round(before, lzw_model.visits - before.visits + LZW_CONTEXTS + LZW_PIPELINE_DEPTH);
+#endif
+        LZW_MODEL_ADD(rounds, 1);
+
+        // The words of this round are written during the next one.
+        busy = false;
+        for (int i = 0; i < LZW_CONTEXTS; i++) {
+            #pragma HLS PIPELINE II=1
+            write_offsets[i] = jobs[i].dst / 4 + written[i];
+            write_words[i] = contexts[i].out_words;
+            written[i] += write_words[i];
+            if (contexts[i].state != CONTEXT_DONE || write_words[i] > 0) busy = true;
+        }
+    }
+
+    for (int i = 0; i < LZW_CONTEXTS; i++) {
+        #pragma HLS PIPELINE II=1
+        descriptors[i].size_out = (contexts[i].out_bits + 7) / 8;
+        epochs[i] = contexts[i].epoch;
+    }
+}
+
+/**************************  Cycle Model Function Declaration ******************************/
+#ifndef __SYNTHESIS__
+void Interleave_model_reset(void) {
+    memset(&lzw_model, 0, sizeof(lzw_model));
+}
+
+const LzwInterleaveModel *Interleave_model_get(void) {
+    return &lzw_model;
+}
+
+void Interleave_model_print(const LzwInterleaveModel *model) {
+    uint64_t cycles = model->compute_cycles + model->burst_cycles;
+    double bytes = model->bytes ? (double)model->bytes : 1.0;
+    double visits = model->visits ? (double)model->visits : 1.0;
+
+    printf("Model: %llu bytes in %llu rounds, %llu estimated cycles (%.2f per byte, %.2f per byte per context)\n",
+           (unsigned long long)model->bytes, (unsigned long long)model->rounds, (unsigned long long)cycles,
+           cycles / bytes, cycles * LZW_CONTEXTS / bytes);
+    printf("Model: compute %llu cycles, bursts not hidden by the engine %llu cycles (%.1f%%)\n",
+           (unsigned long long)model->compute_cycles, (unsigned long long)model->burst_cycles,
+           cycles ? 100.0 * model->burst_cycles / cycles : 0.0);
+    printf("Model: %llu visits, %.1f%% read a byte, %.1f%% probe, %.1f%% clear, %.1f%% idle, %llu resets\n",
+           (unsigned long long)model->visits, 100.0 * model->byte_visits / visits, 100.0 * model->probe_visits / visits,
+           100.0 * model->clear_visits / visits, 100.0 * model->idle_visits / visits, (unsigned long long)model->resets);
+    printf("Model: AXI %llu read bursts (%llu beats), %llu write bursts (%llu beats)\n",
+           (unsigned long long)model->read_bursts, (unsigned long long)model->read_beats,
+           (unsigned long long)model->write_bursts, (unsigned long long)model->write_beats);
+}
+#endif
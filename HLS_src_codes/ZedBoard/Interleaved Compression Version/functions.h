@@ -0,0 +1,305 @@
+#ifndef FUNCTIONS_H
+#define FUNCTIONS_H
+
+/************************** Include Files ******************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ap_int.h>
+
+/************************** Constant Definitions ******************************/
+/*
+ * Stages of one visit in the main loop at 100 MHz: context read (LUTRAM), input block read, byte select
+ * and hash, dictionary address, dictionary read (BRAM cascade and output register), compare and
+ * update of the context, dictionary and output block. A context must not come back before its previous
+ * visit has written back, so the loop keeps II=1 only with at least that many contexts in flight.
+ * Update it from the loop latency of the synthesis report when the visit changes.
+ */
+#ifndef LZW_PIPELINE_DEPTH
+#define LZW_PIPELINE_DEPTH          7
+#endif
+
+/*
+ * Number of independent streams time-multiplexed through the engine. One context is visited per cycle
+ * in strict round robin, so the same context comes back every LZW_CONTEXTS cycles: fewer contexts than
+ * LZW_PIPELINE_DEPTH make the tool raise the II, more only split the input further and cost a dictionary
+ * each.
+ */
+#ifndef LZW_CONTEXTS
+#define LZW_CONTEXTS                LZW_PIPELINE_DEPTH
+#endif
+#ifndef LZW_DICTIONARY_SIZE
+#define LZW_DICTIONARY_SIZE         4096           // Codes allocated before a context resets its dictionary
+#endif
+#ifndef LZW_CODE_BITS
+#define LZW_CODE_BITS               12             // Maximum code width in bits
+#endif
+#ifndef LZW_HASH_BITS
+#define LZW_HASH_BITS               13             // log2 of the hash slots of one context, half full at most
+#endif
+#define LZW_HASH_SIZE               (1u << LZW_HASH_BITS)
+
+/*
+ * Dictionary hash functions, selected at build time with LZW_HASH_FUNCTION, same choices as the HASH
+ * Version (compared by Benchmark_Src_Codes/hash_eval.c). The output does not depend on it, only the
+ * number of probe visits does.
+ */
+#define LZW_HASH_SHIFT_XOR          0              // hash1/hash2 from shifts and XORs
+#define LZW_HASH_MULTIPLICATIVE     1              // Top bits of key * 2654435761 (one DSP multiply)
+#define LZW_HASH_CRC                2              // CRC-32 of the prefix + extension key (an XOR tree, no DSP)
+
+#ifndef LZW_HASH_FUNCTION
+#define LZW_HASH_FUNCTION           LZW_HASH_CRC
+#endif
+#define CRC32_POLY                  0xEDB88320
+
+/*
+ * Every dictionary generation of a context (a job, or the part of a job after a reset) gets a new epoch,
+ * stored with each entry: entries of older epochs read as free, so a new generation starts at once and
+ * only the wrap of the epoch to 0 clears the table, one slot per visit (2^LZW_HASH_BITS visits). The
+ * 12-bit epoch fills the 44-bit words of the 8K x 4 BRAM36 aspect ratio, 11 BRAM36 per context; with a
+ * 4-bit epoch (8 BRAM36) the clear every 16 generations costs more than a 4 KB job.
+ */
+#ifndef LZW_EPOCH_BITS
+#define LZW_EPOCH_BITS              12
+#endif
+#define LZW_ENTRY_BITS              (2 * LZW_CODE_BITS + 8 + LZW_EPOCH_BITS)   // Width of a packed dictionary entry
+
+/*
+ * Input bytes of one context per round. The engine only reads and writes on-chip blocks: a round reads
+ * the next block of every context in one burst each and writes the words the previous round produced,
+ * while the engine works on the other half of the ping-pong blocks. A block must be a multiple of 4.
+ * At the defaults the staging blocks take 2 x 2 (input) + 2 x 3 (output) BRAM36, the dictionaries 7 x 11:
+ * 87 of the 140 BRAM36 of the XC7Z020.
+ */
+#ifndef LZW_BLOCK_SIZE
+#define LZW_BLOCK_SIZE              1024
+#endif
+#define LZW_BLOCK_WORDS             (LZW_BLOCK_SIZE / 4)
+// Output words of one round: one code per input byte and the last one, plus the 43 bits carried over.
+#define LZW_OUT_BLOCK_WORDS         ((LZW_CODE_BITS * (LZW_BLOCK_SIZE + 1) + 43) / 32 + 1)
+#define MEMORY_DEPTH                262144         // Depth of the memory port (32-bit words) seen by C/RTL co-simulation
+#ifndef LZW_MODEL_AXI_LATENCY
+#define LZW_MODEL_AXI_LATENCY       40             // Cycle model: cycles from a burst request to its first beat
+#endif
+
+/* Context states */
+#define CONTEXT_CLEAR               0              // Dictionary clear on an epoch wrap, one slot cleared per visit
+#define CONTEXT_START               1              // First byte not read yet
+#define CONTEXT_LOOKUP              2              // Read the next byte and probe its first slot
+#define CONTEXT_PROBE               3              // Collision on the previous visit: probe the next slot
+#define CONTEXT_WAIT                4              // Input block consumed, waiting for the next round
+#define CONTEXT_FLUSH               5              // Input consumed, draining the bit accumulator
+#define CONTEXT_DONE                6
+
+/**************************** Type Definitions *******************************/
+/**
+ * @brief Dictionary entry used for LZW compression, packed in one word:
+ *        prefix code in the low LZW_CODE_BITS bits, then the extension byte, the code and the epoch.
+ *        Stored codes are always >= 256, so a zero code or an older epoch marks a free slot.
+ */
+typedef ap_uint<LZW_ENTRY_BITS> Dictionary;
+
+/**
+ * @brief Job descriptor of one context, prepared by the host in DDR.
+ *        src and dst are byte offsets from the memory port of top_interleaved_lzw and must be
+ *        multiples of 4: the engine reads and writes whole 32-bit words.
+ */
+typedef struct {
+    uint32_t src;          // Offset of the input chunk
+    uint32_t len;          // Input chunk size in bytes
+    uint32_t dst;          // Offset of the output buffer (2 * len + 4 bytes)
+    uint32_t size_out;     // Compressed size in bytes, written back by the engine
+} LzwDescriptor;
+
+/**
+ * @brief State of one stream, saved and restored on every visit.
+ */
+typedef struct {
+    ap_uint<3> state;                           // CONTEXT_* state
+    uint32_t len;                               // Input size in bytes
+    uint32_t pos;                               // Bytes consumed
+    uint32_t out_bits;                          // Bits emitted
+    uint32_t out_words;                         // Words staged in the output block this round
+    ap_uint<64> acc;                            // Bit accumulator, the pending bits are the low ones
+    ap_uint<7> pending_bits;                    // Bits in acc not written yet
+    ap_uint<LZW_CODE_BITS> prefix;              // Current prefix code
+    ap_uint<8> ext;                             // Byte being looked up
+    ap_uint<LZW_CODE_BITS + 1> dictionary_size; // Next code to allocate
+    ap_uint<5> bit_count;                       // Current code width
+    ap_uint<LZW_EPOCH_BITS> epoch;              // Epoch of the current dictionary generation
+    ap_uint<LZW_HASH_BITS> h1;                  // First slot of the current lookup
+    ap_uint<LZW_HASH_BITS> h2;                  // Probe step of the current lookup
+    ap_uint<LZW_HASH_BITS> slot;                // Slot probed by the next visit
+    uint32_t clear_idx;                         // Next slot to clear in CONTEXT_CLEAR
+    ap_uint<LZW_HASH_BITS> pending_slot;        // Slot written with pending_entry during the clear
+    Dictionary pending_entry;                   // Insert that triggered the clear, 0 at the start of a job
+} LzwContext;
+
+/**
+ * @brief Cycle model of top_interleaved_lzw, filled during C simulation only.
+ *        Every pipelined loop is counted at II=1: per round, the engine loop (its visits, the resume pass
+ *        over the contexts and the pipeline fill) runs concurrently with the read bursts of the next round
+ *        and the write bursts of the previous one, which share the memory port.
+ */
+typedef struct {
+    uint64_t bytes;              // Input bytes compressed
+    uint64_t visits;             // Iterations of the main loop of lzw_interleave
+    uint64_t byte_visits;        // Visits that read an input byte
+    uint64_t probe_visits;       // Visits spent on a collision
+    uint64_t clear_visits;       // Visits spent clearing a dictionary
+    uint64_t idle_visits;        // Visits of a context waiting for its next block or done
+    uint64_t resets;             // Dictionary resets (not counting the start of a job)
+    uint64_t rounds;             // Rounds of top_interleaved_lzw (one more than the compute rounds, to drain the writes)
+    uint64_t read_bursts;        // Read bursts on the memory port
+    uint64_t read_beats;         // Words read
+    uint64_t write_bursts;       // Write bursts on the memory port
+    uint64_t write_beats;        // Words written
+    uint64_t compute_cycles;     // Sum over the rounds of the engine
+    uint64_t burst_cycles;       // Sum over the rounds of the burst cycles beyond the engine
+} LzwInterleaveModel;
+
+/************************** Helper Function Declarations ******************************/
+/**
+ * @brief Mixes prefix and extension into 32 bits with the LZW_HASH_FUNCTION hash, hash1/hash2 are its
+ *        top bits except for LZW_HASH_SHIFT_XOR.
+ *
+ * @param prefix        The prefix code.
+ * @param ext           The extension byte.
+ *
+ * @return 32-bit hash.
+ */
+uint32_t hash_mix(uint32_t prefix, uint32_t ext);
+
+/**
+ * @brief Computes hash functions for dictionary indexing.
+ *
+ * @param prefix        The prefix code.
+ * @param ext           The extension byte.
+ *
+ * @return Hash value for dictionary indexing.
+ */
+uint32_t hash1(uint32_t prefix, uint32_t ext);
+uint32_t hash2(uint32_t prefix, uint32_t ext);
+
+/**
+ * @brief Packs a prefix + extension pair and its code into a dictionary entry.
+ *
+ * @param prefix        The prefix code.
+ * @param ext           The extension byte.
+ * @param code          Assigned code.
+ * @param epoch         Epoch of the dictionary generation.
+ *
+ * @return The packed entry.
+ */
+Dictionary Dictionary_pack(ap_uint<LZW_CODE_BITS> prefix, ap_uint<8> ext, ap_uint<LZW_CODE_BITS> code, ap_uint<LZW_EPOCH_BITS> epoch);
+
+/**
+ * @brief Loads a job descriptor into a context.
+ *
+ * @param context       Context to initialise.
+ * @param job           Job descriptor.
+ * @param epoch         Epoch of its first dictionary generation, 0 clears the dictionary first.
+ */
+void Context_init(LzwContext &context, const LzwDescriptor &job, ap_uint<LZW_EPOCH_BITS> epoch);
+
+/**
+ * @brief Returns the next input byte of a context from its input block.
+ *
+ * @param context       Context to read from.
+ * @param block         Input block of the context for this round.
+ *
+ * @return The input byte.
+ */
+ap_uint<8> Context_next_byte(LzwContext &context, ap_uint<32> block[LZW_BLOCK_WORDS]);
+
+/**
+ * @brief Appends a code to the bit accumulator of a context.
+ *
+ * @param context       Context to write to.
+ * @param code          Code to emit, context.bit_count bits wide.
+ */
+void Context_emit(LzwContext &context, ap_uint<LZW_CODE_BITS> code);
+
+/**
+ * @brief Converts 32 bits of the code stream (first bit in bit 31) to a little-endian memory word.
+ *
+ * @param bits          Stream bits.
+ *
+ * @return The word to store.
+ */
+uint32_t stream_word(uint32_t bits);
+
+/**
+ * @brief Reads the next input block of every context with input left, one burst each.
+ *
+ * @param memory        Memory window of the descriptors.
+ * @param jobs          Job descriptors.
+ * @param consumed      Input bytes already read per context, advanced by the block.
+ * @param blocks        Input blocks to fill.
+ */
+void Round_read(ap_uint<32> *memory, LzwDescriptor jobs[LZW_CONTEXTS], uint32_t consumed[LZW_CONTEXTS],
+                ap_uint<32> blocks[LZW_CONTEXTS][LZW_BLOCK_WORDS]);
+
+/**
+ * @brief Writes the output words staged by the previous round, one burst per context.
+ *
+ * @param memory        Memory window of the descriptors.
+ * @param offsets       Word offset of each burst.
+ * @param words         Words of each burst, 0 for none.
+ * @param blocks        Output blocks to drain.
+ */
+void Round_write(ap_uint<32> *memory, uint32_t offsets[LZW_CONTEXTS], uint32_t words[LZW_CONTEXTS],
+                 ap_uint<32> blocks[LZW_CONTEXTS][LZW_OUT_BLOCK_WORDS]);
+
+/************************** Main Function Declaration ******************************/
+/**
+ * @brief Interleaved LZW engine: runs one round of all the contexts through one pipelined loop.
+ *        Each iteration serves a different context, so a dictionary access of one stream overlaps with
+ *        the next LZW_CONTEXTS - 1 streams instead of stalling the pipeline. The round ends when every
+ *        context has consumed its input block or is done, so the contexts that hit fewer collisions in
+ *        their block wait for the slowest one (see idle_visits in the C simulation cycle model).
+ *        The K dictionaries live in one memory, the context number in the upper address bits.
+ *
+ * @param contexts      The LZW_CONTEXTS contexts.
+ * @param in_blocks     Input block of each context for this round.
+ * @param out_blocks    Output block of each context, filled from word 0.
+ * @param limit         Input bytes of each job available at the end of this round.
+ */
+void lzw_interleave(LzwContext contexts[LZW_CONTEXTS], ap_uint<32> in_blocks[LZW_CONTEXTS][LZW_BLOCK_WORDS],
+                    ap_uint<32> out_blocks[LZW_CONTEXTS][LZW_OUT_BLOCK_WORDS], uint32_t limit);
+
+/**************************  Top Function Declaration ******************************/
+/**
+ * @brief Top-level interleaved LZW compression function for HLS.
+ *        Fetches LZW_CONTEXTS descriptors, compresses them all in the interleaved engine and writes
+ *        the compressed sizes back into the descriptors. Output is bit-exact with lzw_compress.
+ *
+ * @param descriptors   Pointer to the array of LZW_CONTEXTS job descriptors.
+ * @param memory        Base of the memory window the descriptor offsets refer to.
+ */
+void top_interleaved_lzw(LzwDescriptor *descriptors, ap_uint<32> *memory);
+
+/**************************  Cycle Model Function Declarations ******************************/
+#ifndef __SYNTHESIS__
+/**
+ * @brief Clears the cycle model before a run.
+ */
+void Interleave_model_reset(void);
+
+/**
+ * @brief Returns the cycle model accumulated since the last Interleave_model_reset.
+ */
+const LzwInterleaveModel *Interleave_model_get(void);
+
+/**
+ * @brief Prints the cycle model.
+ *
+ * @param model         Model to print.
+ */
+void Interleave_model_print(const LzwInterleaveModel *model);
+#endif
+
+
+#endif
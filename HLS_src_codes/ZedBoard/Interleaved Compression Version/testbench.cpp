@@ -0,0 +1,193 @@
+/*
+ * Every context gets a different stream (sizes, contents, dictionary resets) so they finish at different
+ * times; each output is checked against a plain single-stream LZW encoder with the lzw_compress semantics.
+ */
+#include "functions.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+#define CALLS 6
+
+static ap_uint<32> memory[MEMORY_DEPTH];
+
+static void put_bits(std::vector<uint8_t> &out, uint32_t &bit_index, uint32_t code, uint32_t bit_count)
+{
+    for (int b = bit_count - 1; b >= 0; b--) {
+        if (bit_index % 8 == 0) out.push_back(0);
+        if ((code >> b) & 1) out.back() |= 0x80 >> (bit_index % 8);
+        bit_index++;
+    }
+}
+
+// Reference model: same code allocation, width growth and reset rule as lzw_compress.
+static std::vector<uint8_t> reference_lzw(const uint8_t *input, uint32_t size)
+{
+    std::vector<uint8_t> out;
+    if (size == 0) return out;
+
+    std::map<uint32_t, uint32_t> dictionary;
+    uint32_t dictionary_size = 256, bit_count = 8, bit_index = 0;
+    uint32_t prefix = input[0];
+
+    for (uint32_t i = 1; i < size; i++) {
+        uint32_t key = (prefix << 8) | input[i];
+        std::map<uint32_t, uint32_t>::iterator it = dictionary.find(key);
+        if (it != dictionary.end()) {
+            prefix = it->second;
+            continue;
+        }
+        put_bits(out, bit_index, prefix, bit_count);
+        if (dictionary_size >= LZW_DICTIONARY_SIZE) {
+            dictionary.clear();
+            dictionary_size = 256;
+            bit_count = 8;
+        }
+        if (dictionary_size >= (1u << bit_count)) bit_count++;
+        dictionary[key] = dictionary_size++;
+        prefix = input[i];
+    }
+    put_bits(out, bit_index, prefix, bit_count);
+    return out;
+}
+
+/**
+ * @brief Compresses a whole file split over the contexts, as the benchmark does, checks every context
+ *        against the reference and prints the cycle model of the run.
+ *
+ * @param path          Corpus file.
+ *
+ * @return 0 on success, 1 if the file cannot be read or an output differs.
+ */
+static int run_corpus(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("Cannot open %s\n", path);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    uint32_t size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    std::vector<uint8_t> bytes(size + 1);
+    if (fread(bytes.data(), 1, size, file) != size) size = 0;
+    fclose(file);
+
+    // Word aligned input, then a 2 * len + 4 byte output buffer, per context.
+    LzwDescriptor descriptors[LZW_CONTEXTS];
+    uint32_t starts[LZW_CONTEXTS];
+    uint32_t offset = 0;
+    for (int i = 0; i < LZW_CONTEXTS; i++) {
+        starts[i] = size / LZW_CONTEXTS * i + (i < (int)(size % LZW_CONTEXTS) ? i : size % LZW_CONTEXTS);
+        descriptors[i].src = offset;
+        descriptors[i].len = size / LZW_CONTEXTS + (i < (int)(size % LZW_CONTEXTS) ? 1 : 0);
+        descriptors[i].dst = offset + ((descriptors[i].len + 3) & ~3u);
+        descriptors[i].size_out = 0;
+        offset = descriptors[i].dst + ((2 * descriptors[i].len + 4 + 3) & ~3u);
+    }
+
+    ap_uint<32> *words = new ap_uint<32>[offset / 4];
+    for (uint32_t i = 0; i < offset / 4; i++) words[i] = 0;
+    for (int i = 0; i < LZW_CONTEXTS; i++) {
+        for (uint32_t j = 0; j < descriptors[i].len; j++) {
+            uint32_t word = (descriptors[i].src + j) / 4, lane = (descriptors[i].src + j) % 4;
+            words[word] = words[word] | (ap_uint<32>(bytes[starts[i] + j]) << (8 * lane));
+        }
+    }
+
+    Interleave_model_reset();
+    top_interleaved_lzw(descriptors, words);
+
+    uint64_t compressed = 0;
+    int errors = 0;
+    for (int i = 0; i < LZW_CONTEXTS; i++) {
+        std::vector<uint8_t> expected = reference_lzw(bytes.data() + starts[i], descriptors[i].len);
+        bool ok = descriptors[i].size_out == expected.size();
+        for (uint32_t j = 0; ok && j < expected.size(); j++) {
+            uint32_t word = (descriptors[i].dst + j) / 4, lane = (descriptors[i].dst + j) % 4;
+            ok = ((words[word] >> (8 * lane)) & 0xFF) == expected[j];
+        }
+        if (!ok) errors++;
+        compressed += descriptors[i].size_out;
+    }
+    printf("%s: %u -> %llu bytes (%.2f%%), %d mismatching contexts\n", path, size, (unsigned long long)compressed,
+           size ? 100.0 * compressed / size : 0.0, errors);
+    Interleave_model_print(Interleave_model_get());
+
+    delete[] words;
+    return errors ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    // csim -argv "<corpus> ...": cycle model on real files instead of the built-in streams.
+    if (argc > 1) {
+        int errors = 0;
+        for (int i = 1; i < argc; i++) errors += run_corpus(argv[i]);
+        return errors;
+    }
+
+    static const uint32_t sizes[8] = {0, 1, 9, 24, 5000, 70000, 33333, 100000};
+    static uint8_t data[LZW_CONTEXTS][100000];
+    LzwDescriptor descriptors[LZW_CONTEXTS];
+    uint32_t seed = 1;
+    uint32_t offset = 0;
+    int errors = 0;
+
+    for (int i = 0; i < LZW_CONTEXTS; i++) {
+        uint32_t size = sizes[i % 8];
+        for (uint32_t j = 0; j < size; j++) {
+            seed = seed * 1103515245u + 12345u;
+            switch (i % 4) {
+            case 0:  data[i][j] = "ABAABAAAB"[j % 9]; break;                     // Short repeats
+            case 1:  data[i][j] = 'a' + ((seed >> 16) % 6); break;               // Small alphabet
+            case 2:  data[i][j] = seed >> 16; break;                             // Random, resets often
+            default: data[i][j] = 'A' + (j / 700) % 26; break;                   // Long runs
+            }
+        }
+
+        // Input, then a 2 * len + 4 byte output buffer, both word aligned.
+        descriptors[i].src = offset;
+        descriptors[i].len = size;
+        descriptors[i].dst = offset + ((size + 3) & ~3u);
+        descriptors[i].size_out = 0;
+        for (uint32_t j = 0; j < size; j++) {
+            uint32_t word = (offset + j) / 4, lane = (offset + j) % 4;
+            memory[word] = memory[word] | (ap_uint<32>(data[i][j]) << (8 * lane));
+        }
+        offset = descriptors[i].dst + ((2 * size + 4 + 3) & ~3u);
+    }
+    if (offset / 4 > MEMORY_DEPTH) {
+        printf("Test data does not fit in MEMORY_DEPTH\n");
+        return 1;
+    }
+
+    // Later calls reuse the dictionaries on new epochs; resets add more, so -DLZW_EPOCH_BITS=2 also
+    // covers the wrap and its clear.
+    for (int call = 0; call < CALLS; call++) {
+        for (int i = 0; i < LZW_CONTEXTS; i++) {
+            for (uint32_t j = 0; j < (2 * descriptors[i].len + 4) / 4; j++) memory[descriptors[i].dst / 4 + j] = 0;
+            descriptors[i].size_out = 0;
+        }
+
+        top_interleaved_lzw(descriptors, memory);
+
+        int call_errors = 0;
+        for (int i = 0; i < LZW_CONTEXTS; i++) {
+            std::vector<uint8_t> expected = reference_lzw(data[i], descriptors[i].len);
+            bool ok = descriptors[i].size_out == expected.size();
+            for (uint32_t j = 0; ok && j < expected.size(); j++) {
+                uint32_t word = (descriptors[i].dst + j) / 4, lane = (descriptors[i].dst + j) % 4;
+                ok = ((memory[word] >> (8 * lane)) & 0xFF) == expected[j];
+            }
+            if (call == 0) printf("Context %d: %6u bytes -> %6u compressed: %s\n", i, descriptors[i].len, descriptors[i].size_out, ok ? "OK" : "MISMATCH");
+            if (!ok) call_errors++;
+        }
+        if (call == 0) printf("%d mismatching contexts\n", call_errors);
+        errors += call_errors;
+    }
+    printf("Calls: %d mismatching contexts over %d calls\n", errors, CALLS);
+
+    return errors;
+}
@@ -1,254 +1,502 @@
 #include "functions.h"
+#ifndef __SYNTHESIS__
+#include <stdio.h>
+
+static LzwCycleModel lzw_model;
+#define LZW_MODEL_ADD(field, value) (lzw_model.field += (value))
+#else
+#define LZW_MODEL_ADD(field, value)
+#endif
 
 /**************************  Helper Functions Declarations ******************************/
-void init_dictionary(Dictionary *dictionary, bool *dictionary_used) {
+template <int CODE_BITS>
+Dictionary<CODE_BITS> Dictionary_pack(ap_uint<CODE_BITS> prefix, ap_uint<8> ext, ap_uint<CODE_BITS> code) {
+    #pragma HLS INLINE
+    return (code, ext, prefix);
+}
+
+template <int CODE_BITS, int HASH_SIZE>
+void init_dictionary(Dictionary<CODE_BITS> *dictionary) {
     #pragma HLS INLINE off
-    memset(dictionary_used, 0, sizeof(bool) * MAX_DICTIONARY_SIZE);
-    for (uint16_t i = 0; i < 256; i++) {
+    // Single-byte codes are implicit: Dictionary_find is only ever called with a prefix code.
+    for (uint32_t i = 0; i < HASH_SIZE; i++) {
         #pragma HLS PIPELINE II=1
-        dictionary[i].code = i;
-        dictionary[i].prefix_code = INVALID_CODE;
-        dictionary[i].ext_byte = i;
-        dictionary_used[i] = true;
+        dictionary[i] = 0;
     }
+    LZW_MODEL_ADD(clear_iterations, HASH_SIZE);
 }
 
-void Dictionary_reset(Dictionary *dictionary, bool *dictionary_used, uint16_t *dictionary_size, uint8_t *bit_count) {
+template <int CODE_BITS, int HASH_SIZE>
+void Dictionary_reset(Dictionary<CODE_BITS> *dictionary, ap_uint<CODE_BITS + 1> &dictionary_size, ap_uint<5> &bit_count) {
     #pragma HLS INLINE off
-    *dictionary_size = 256;
-    *bit_count = 8;
-    init_dictionary(dictionary, dictionary_used);
+    dictionary_size = 256;
+    bit_count = 8;
+    init_dictionary<CODE_BITS, HASH_SIZE>(dictionary);
+}
+
+uint32_t bram36_count(uint32_t depth, uint32_t width) {
+    // BRAM36 aspect ratios (depth x width), the narrowest that fits wins.
+    static const uint32_t depths[7] = {32768, 16384, 8192, 4096, 2048, 1024, 512};
+    static const uint32_t widths[7] = {1, 2, 4, 9, 18, 36, 72};
+    uint32_t best = 0xFFFFFFFF;
+    for (int i = 0; i < 7; i++) {
+        uint32_t count = ((depth + depths[i] - 1) / depths[i]) * ((width + widths[i] - 1) / widths[i]);
+        if (count < best) best = count;
+    }
+    return best;
+}
+
+template <int CODE_BITS>
+uint32_t hash_mix(uint32_t prefix, uint32_t ext) {
+    #pragma HLS INLINE
+    uint32_t key = (ext << CODE_BITS) | prefix;
+#if LZW_HASH_FUNCTION == LZW_HASH_CRC
+    // One step of the reflected CRC register per key bit, unrolled into an XOR tree.
+    for (int i = 0; i < CODE_BITS + 8; i++) {
+        #pragma HLS UNROLL
+        key = (key >> 1) ^ (CRC32_POLY & (0u - (key & 1)));
+    }
+    return key;
+#else
+    return key * 2654435761u;
+#endif
 }
 
-uint32_t hash1(uint16_t prefix, uint8_t ext) {
+template <int CODE_BITS, int HASH_SIZE>
+uint32_t hash1(uint32_t prefix, uint32_t ext) {
     #pragma HLS INLINE
-    return ((prefix << 8) ^ ext) & (MAX_DICTIONARY_SIZE - 1);
+#if LZW_HASH_FUNCTION == LZW_HASH_SHIFT_XOR
+    return ((prefix << 8) ^ ext) & (HASH_SIZE - 1);
+#else
+    // Top log2(HASH_SIZE) bits, HASH_SIZE being a power of two.
+    return ((uint64_t)hash_mix<CODE_BITS>(prefix, ext) * HASH_SIZE) >> 32;
+#endif
 }
 
-uint32_t hash2(uint16_t prefix, uint8_t ext) {
+template <int CODE_BITS, int HASH_SIZE>
+uint32_t hash2(uint32_t prefix, uint32_t ext) {
     #pragma HLS INLINE
-    return (((prefix << 5) ^ (ext * 7)) & (MAX_DICTIONARY_SIZE - 1)) | 1;
+#if LZW_HASH_FUNCTION == LZW_HASH_SHIFT_XOR
+    return (((prefix << 5) ^ (ext * 7)) & (HASH_SIZE - 1)) | 1;
+#else
+    return ((hash_mix<CODE_BITS>(prefix, ext) >> 8) & (HASH_SIZE - 1)) | 1;
+#endif
 }
 
-uint16_t Dictionary_find(Dictionary *dictionary, bool *dictionary_used, uint16_t prefix, uint8_t ext) {
+template <int CODE_BITS, int HASH_SIZE>
+bool Dictionary_find(
+    Dictionary<CODE_BITS> *dictionary,
+    ap_uint<CODE_BITS> prefix, ap_uint<8> ext, ap_uint<CODE_BITS> &code, uint32_t &probes
+) {
     #pragma HLS INLINE off
-    uint32_t h1 = hash1(prefix, ext);
-    uint32_t h2 = hash2(prefix, ext);
+    uint32_t h1 = hash1<CODE_BITS, HASH_SIZE>(prefix, ext);
+    uint32_t h2 = hash2<CODE_BITS, HASH_SIZE>(prefix, ext);
+    ap_uint<CODE_BITS + 8> key = (ext, prefix);
 
-    for (uint32_t i = 0; i < MAX_DICTIONARY_SIZE; i++) {
+    for (uint32_t i = 0; i < HASH_SIZE; i++) {
         #pragma HLS PIPELINE II=1
-        uint32_t idx = (h1 + i * h2) & (MAX_DICTIONARY_SIZE - 1);
-
-        if (!dictionary_used[idx]) return INVALID_CODE;
-        if (dictionary[idx].prefix_code == prefix && dictionary[idx].ext_byte == ext) return dictionary[idx].code;
+        uint32_t idx = (h1 + i * h2) & (HASH_SIZE - 1);
+        Dictionary<CODE_BITS> entry = dictionary[idx];
+        probes++;
+        LZW_MODEL_ADD(find_probes, 1);
+        ap_uint<CODE_BITS> entry_code = entry.range(2 * CODE_BITS + 7, CODE_BITS + 8);
 
+        if (entry_code == 0) return false;
+        if (entry.range(CODE_BITS + 7, 0) == key) {
+            code = entry_code;
+            return true;
+        }
     }
-    return INVALID_CODE;
+    return false;
 }
 
+template <int DICT_SIZE, int CODE_BITS, int HASH_SIZE>
 void Dictionary_add(
-    Dictionary *dictionary, bool *dictionary_used,
-    uint16_t prefix, uint8_t ext,
-    uint16_t *dictionary_size, uint8_t *bit_count
+    Dictionary<CODE_BITS> *dictionary,
+    ap_uint<CODE_BITS> prefix, ap_uint<8> ext,
+    ap_uint<CODE_BITS + 1> &dictionary_size, ap_uint<5> &bit_count, uint32_t &probes
 ) {
     #pragma HLS INLINE off
-    if (*dictionary_size >= MAX_DICTIONARY_SIZE) Dictionary_reset(dictionary, dictionary_used, dictionary_size, bit_count);
-    if (*dictionary_size >= (1u << *bit_count)) (*bit_count)++;
+    if (dictionary_size >= DICT_SIZE) {
+        Dictionary_reset<CODE_BITS, HASH_SIZE>(dictionary, dictionary_size, bit_count);
+        probes += HASH_SIZE;
+        LZW_MODEL_ADD(resets, 1);
+    }
+    if (dictionary_size >= (1u << bit_count)) bit_count++;
 
-    uint32_t h1 = hash1(prefix, ext);
-    uint32_t h2 = hash2(prefix, ext);
-    for (uint32_t i = 0; i < MAX_DICTIONARY_SIZE; i++) {
+    uint32_t h1 = hash1<CODE_BITS, HASH_SIZE>(prefix, ext);
+    uint32_t h2 = hash2<CODE_BITS, HASH_SIZE>(prefix, ext);
+    for (uint32_t i = 0; i < HASH_SIZE; i++) {
         #pragma HLS PIPELINE II=1
-        uint32_t idx = (h1 + i * h2) & (MAX_DICTIONARY_SIZE - 1);
-        
-        if (!dictionary_used[idx]) {
-            dictionary[idx].prefix_code = prefix;
-            dictionary[idx].ext_byte = ext;
-            dictionary[idx].code = *dictionary_size;
-            dictionary_used[idx] = true;
-            (*dictionary_size)++;
+        uint32_t idx = (h1 + i * h2) & (HASH_SIZE - 1);
+        probes++;
+        LZW_MODEL_ADD(add_probes, 1);
+
+        if (dictionary[idx].range(2 * CODE_BITS + 7, CODE_BITS + 8) == 0) {
+            dictionary[idx] = Dictionary_pack<CODE_BITS>(prefix, ext, dictionary_size);
+            dictionary_size++;
             return;
         }
     }
 }
 
-void write_output(uint16_t code, uint8_t *output, uint8_t bit_count, uint32_t *out_index) {
+ap_uint<8> Block_byte(MemoryWord *block, uint32_t index) {
+    #pragma HLS INLINE
+    uint32_t lane = index % MEMORY_WORD_BYTES;
+    return block[index / MEMORY_WORD_BYTES].range(8 * lane + 7, 8 * lane);
+}
+
+template <int CODE_BITS>
+void write_output(ap_uint<CODE_BITS> code, MemoryWord *output, ap_uint<5> bit_count, uint32_t *out_index) {
     #pragma HLS INLINE off
     uint32_t idx = *out_index;
     uint32_t byte_index = idx / 8;
     uint32_t bit_offset = idx % 8;
+    uint32_t word_index = idx / MEMORY_WORD_BITS;
+    // A word started by an earlier code (or carried from the previous round) is read back once.
+    MemoryWord word = (idx % MEMORY_WORD_BITS == 0) ? MemoryWord(0) : output[word_index];
 
     uint32_t bits_left = bit_count;
+    uint32_t value = code;
     while (bits_left > 0) {
         #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT max=CODE_BITS
         uint8_t space_in_byte = 8 - bit_offset;
         uint8_t bits_to_write = (bits_left < space_in_byte) ? bits_left : space_in_byte;
-        uint8_t mask = ((code >> (bits_left - bits_to_write)) & ((1U << bits_to_write) - 1));
-
-        if (bit_offset == 0) output[byte_index] = 0;
+        uint8_t mask = ((value >> (bits_left - bits_to_write)) & ((1U << bits_to_write) - 1));
+        LZW_MODEL_ADD(write_iterations, 1);
 
-        output[byte_index] |= mask << (space_in_byte - bits_to_write);
+        uint32_t lane = byte_index % MEMORY_WORD_BYTES;
+        ap_uint<8> byte = (bit_offset == 0) ? ap_uint<8>(0) : ap_uint<8>(word.range(8 * lane + 7, 8 * lane));
+        word.range(8 * lane + 7, 8 * lane) = byte | ap_uint<8>(mask << (space_in_byte - bits_to_write));
         bit_offset += bits_to_write;
         if (bit_offset == 8) {
             bit_offset = 0;
             byte_index++;
+            if (lane == MEMORY_WORD_BYTES - 1) {
+                output[word_index] = word;
+                word_index++;
+                word = 0;
+            }
         }
         bits_left -= bits_to_write;
     }
+    // A word left partial is stored too (an exactly filled one is already stored).
+    if ((idx + bit_count) % MEMORY_WORD_BITS != 0) output[word_index] = word;
     *out_index += bit_count;
 }
 
-/**************************  Main Compression Function Declaration ******************************/
-void lzw_compress(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size) {
+void Burst_read(MemoryWord *memory, uint32_t offset, uint32_t count, MemoryWord block[LZW_IN_BLOCK_WORDS]) {
     #pragma HLS INLINE off
-    Dictionary dictionary[MAX_DICTIONARY_SIZE];
-    bool dictionary_used[MAX_DICTIONARY_SIZE];
+    uint32_t skip = offset % MEMORY_WORD_BYTES;
+    uint32_t words = (skip + count + MEMORY_WORD_BYTES - 1) / MEMORY_WORD_BYTES;
+    uint32_t block_words = (count + MEMORY_WORD_BYTES - 1) / MEMORY_WORD_BYTES;
+    MemoryWord *base = memory + offset / MEMORY_WORD_BYTES;
+    LZW_MODEL_ADD(read_bursts, 1);
+    LZW_MODEL_ADD(read_beats, words);
 
-    uint16_t dictionary_size = 256;
-    uint8_t bit_count = 8;
-    uint32_t out_index = 0;
+    // Block word w is the top bytes of memory word w then the bottom bytes of memory word w + 1.
+    MemoryWord previous = 0;
+    for (uint32_t w = 0; w < words; w++) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT max=LZW_IN_BLOCK_WORDS+1
+        MemoryWord word = base[w];
+        if (w > 0) block[w - 1] = (skip == 0) ? previous : MemoryWord((previous >> (8 * skip)) | (word << (MEMORY_WORD_BITS - 8 * skip)));
+        previous = word;
+    }
+    // Unless the bytes spill into one more memory word, the last block word is the tail of the last beat.
+    if (words == block_words) block[block_words - 1] = previous >> (8 * skip);
+}
 
-    if (input_size == 0) {
-        *compression_size = 0;
-        return;
+void Burst_write(MemoryWord *memory, uint32_t offset, uint32_t words, MemoryWord block[LZW_OUT_BLOCK_WORDS]) {
+    #pragma HLS INLINE off
+    MemoryWord *base = memory + offset / MEMORY_WORD_BYTES;
+    if (words > 0) {
+        LZW_MODEL_ADD(write_bursts, 1);
+        LZW_MODEL_ADD(write_beats, words);
     }
-    
-    if (input_size == 1) {
-        write_output(input[0], output, bit_count, &out_index);
-        *compression_size = (out_index + 7) /8;
-        return;
+
+    for (uint32_t w = 0; w < words; w++) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT max=LZW_OUT_BLOCK_WORDS
+        base[w] = block[w];
     }
+}
 
-    init_dictionary(dictionary, dictionary_used);
+/**************************  Main Compression Function Declaration ******************************/
+template <int DICT_SIZE, int CODE_BITS, int HASH_SIZE>
+void lzw_compress_block(
+    LzwEngineState<CODE_BITS> &state, Dictionary<CODE_BITS> *dictionary,
+    MemoryWord *input, uint32_t count, bool last, MemoryWord *output, uint32_t *out_index
+) {
+    #pragma HLS INLINE off
+    static_assert(DICT_SIZE >= 1024 && DICT_SIZE <= 65536, "DICT_SIZE must be between 1K and 64K codes");
+    static_assert(CODE_BITS >= 10 && CODE_BITS <= 16, "CODE_BITS must be between 10 and 16");
+    static_assert(DICT_SIZE <= (1 << CODE_BITS), "DICT_SIZE codes do not fit in CODE_BITS");
+    static_assert(HASH_SIZE >= DICT_SIZE && (HASH_SIZE & (HASH_SIZE - 1)) == 0, "HASH_SIZE must be a power of two >= DICT_SIZE");
 
-    uint16_t prefix = input[0];
-    uint8_t ext = input[1];
+    if (count == 0) return;
 
-    write_output(prefix, output, bit_count, &out_index);
-    Dictionary_add(dictionary, dictionary_used, prefix, ext, &dictionary_size, &bit_count);
-    prefix = ext;
+    uint32_t i = 0;
+    if (!state.started) {
+        Dictionary_reset<CODE_BITS, HASH_SIZE>(dictionary, state.dictionary_size, state.bit_count);
+        state.cycles += HASH_SIZE;
+        state.prefix = Block_byte(input, 0);
+        state.started = true;
+        i = 1;
+    }
 
-    for (int i = 2; i < input_size; i++){ 
-        uint8_t ext = input[i];
-        uint16_t code = Dictionary_find(dictionary, dictionary_used, prefix, ext);
-        if (code != INVALID_CODE){
-            prefix = code;
+    for (; i < count; i++){
+        #pragma HLS LOOP_TRIPCOUNT max=LZW_BLOCK_SIZE
+        ap_uint<8> ext = Block_byte(input, i);
+        ap_uint<CODE_BITS> code;
+        state.cycles++;
+        LZW_MODEL_ADD(engine_bytes, 1);
+        if (Dictionary_find<CODE_BITS, HASH_SIZE>(dictionary, state.prefix, ext, code, state.cycles)){
+            state.prefix = code;
         } else {
-            write_output(prefix, output, bit_count, &out_index);
-            Dictionary_add(dictionary, dictionary_used, prefix, ext, &dictionary_size, &bit_count);
-            prefix = ext;
+            state.cycles += (*out_index % 8 + state.bit_count + 7) / 8;
+            write_output<CODE_BITS>(state.prefix, output, state.bit_count, out_index);
+            Dictionary_add<DICT_SIZE, CODE_BITS, HASH_SIZE>(dictionary, state.prefix, ext, state.dictionary_size, state.bit_count, state.cycles);
+            state.prefix = ext;
         }
     }
-    write_output(prefix, output, bit_count, &out_index);
 
-    while (out_index % 8 != 0) {
-        output[out_index / 8] |= (0 << (7 - out_index % 8));
-        out_index++;
+    if (last) {
+        state.cycles += (*out_index % 8 + state.bit_count + 7) / 8;
+        write_output<CODE_BITS>(state.prefix, output, state.bit_count, out_index);
+        // The last byte is zero padded: write_output clears every byte it starts.
+        *out_index = (*out_index + 7) / 8 * 8;
     }
-    
-    *compression_size = (out_index + 7) /8;
 }
 
-/**************************  Main Parallel Compression Function Declaration ******************************/
-void top_parallel_lzw(
-    uint8_t* input1, int input_size1,
-    uint8_t* input2, int input_size2,
-    uint8_t* input3, int input_size3,
-    uint8_t* input4, int input_size4,
-    uint8_t* input5, int input_size5,
-    uint8_t* input6, int input_size6,
-    uint8_t* input7, int input_size7,
-    uint8_t* input8, int input_size8,
-    uint8_t* input9, int input_size9,
-    uint8_t* input10, int input_size10,
-    uint8_t* output1, uint32_t* compression_size1,
-    uint8_t* output2, uint32_t* compression_size2,
-    uint8_t* output3, uint32_t* compression_size3,
-    uint8_t* output4, uint32_t* compression_size4,
-    uint8_t* output5, uint32_t* compression_size5,
-    uint8_t* output6, uint32_t* compression_size6,
-    uint8_t* output7, uint32_t* compression_size7,
-    uint8_t* output8, uint32_t* compression_size8,
-    uint8_t* output9, uint32_t* compression_size9,
-    uint8_t* output10, uint32_t* compression_size10
+/**************************  Round Functions Declarations ******************************/
+void Round_read(
+    MemoryWord *memory, LzwDescriptor jobs[NUMBER_PARALLEL_FUNCTIONS], uint32_t consumed[NUMBER_PARALLEL_FUNCTIONS],
+    uint32_t counts[NUMBER_PARALLEL_FUNCTIONS], bool lasts[NUMBER_PARALLEL_FUNCTIONS],
+    MemoryWord blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_IN_BLOCK_WORDS]
+) {
+    #pragma HLS INLINE off
+    // One burst per engine with input left.
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        uint32_t left = jobs[i].len - consumed[i];
+        counts[i] = (left < LZW_BLOCK_SIZE) ? left : LZW_BLOCK_SIZE;
+        lasts[i] = counts[i] == left;
+        if (counts[i] > 0) Burst_read(memory, jobs[i].src + consumed[i], counts[i], blocks[i]);
+        consumed[i] += counts[i];
+    }
+}
+
+void Round_compute(
+    LzwEngineState<LZW_CODE_BITS> states[NUMBER_PARALLEL_FUNCTIONS],
+    Dictionary<LZW_CODE_BITS> dictionaries[NUMBER_PARALLEL_FUNCTIONS][LZW_HASH_SIZE],
+    MemoryWord in_blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_IN_BLOCK_WORDS], uint32_t counts[NUMBER_PARALLEL_FUNCTIONS],
+    bool lasts[NUMBER_PARALLEL_FUNCTIONS], MemoryWord out_blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS],
+    uint32_t out_bits[NUMBER_PARALLEL_FUNCTIONS]
+) {
+    #pragma HLS INLINE off
+    // One engine instance per iteration, the unrolled calls run concurrently.
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        #pragma HLS UNROLL
+        lzw_compress_block<LZW_DICTIONARY_SIZE, LZW_CODE_BITS, LZW_HASH_SIZE>(
+            states[i], dictionaries[i], in_blocks[i], counts[i], lasts[i], out_blocks[i], &out_bits[i]
+        );
+        LZW_MODEL_ADD(bytes, counts[i]);
+    }
+}
+
+void Round_write(
+    MemoryWord *memory, uint32_t offsets[NUMBER_PARALLEL_FUNCTIONS], uint32_t words[NUMBER_PARALLEL_FUNCTIONS],
+    MemoryWord blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS]
 ) {
-    #pragma HLS INTERFACE m_axi depth=input_size1   port=input1     offset=slave bundle=AXIM_1
-    #pragma HLS INTERFACE m_axi depth=input_size2   port=input2     offset=slave bundle=AXIM_2
-    #pragma HLS INTERFACE m_axi depth=input_size3   port=input3     offset=slave bundle=AXIM_3
-    #pragma HLS INTERFACE m_axi depth=input_size4   port=input4     offset=slave bundle=AXIM_4
-    #pragma HLS INTERFACE m_axi depth=input_size5   port=input5     offset=slave bundle=AXIM_5
-    #pragma HLS INTERFACE m_axi depth=input_size6   port=input6     offset=slave bundle=AXIM_6
-    #pragma HLS INTERFACE m_axi depth=input_size7   port=input7     offset=slave bundle=AXIM_7
-    #pragma HLS INTERFACE m_axi depth=input_size8   port=input8     offset=slave bundle=AXIM_8
-    #pragma HLS INTERFACE m_axi depth=input_size9   port=input9     offset=slave bundle=AXIM_9
-    #pragma HLS INTERFACE m_axi depth=input_size10  port=input10    offset=slave bundle=AXIM_10
-
-    #pragma HLS INTERFACE m_axi depth=input_size1   port=output1    offset=slave bundle=AXIM_1
-    #pragma HLS INTERFACE m_axi depth=input_size2   port=output2    offset=slave bundle=AXIM_2
-    #pragma HLS INTERFACE m_axi depth=input_size3   port=output3    offset=slave bundle=AXIM_3
-    #pragma HLS INTERFACE m_axi depth=input_size4   port=output4    offset=slave bundle=AXIM_4
-    #pragma HLS INTERFACE m_axi depth=input_size5   port=output5    offset=slave bundle=AXIM_5
-    #pragma HLS INTERFACE m_axi depth=input_size6   port=output6    offset=slave bundle=AXIM_6
-    #pragma HLS INTERFACE m_axi depth=input_size7   port=output7    offset=slave bundle=AXIM_7
-    #pragma HLS INTERFACE m_axi depth=input_size8   port=output8    offset=slave bundle=AXIM_8
-    #pragma HLS INTERFACE m_axi depth=input_size9   port=output9    offset=slave bundle=AXIM_9
-    #pragma HLS INTERFACE m_axi depth=input_size10  port=output10   offset=slave bundle=AXIM_10
-
-    #pragma HLS INTERFACE s_axilite port=input1   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input2   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input3   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input4   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input5   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input6   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input7   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input8   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input9   bundle=control
-    #pragma HLS INTERFACE s_axilite port=input10  bundle=control
-
-    #pragma HLS INTERFACE s_axilite port=output1  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output2  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output3  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output4  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output5  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output6  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output7  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output8  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output9  bundle=control
-    #pragma HLS INTERFACE s_axilite port=output10 bundle=control
-
-    #pragma HLS INTERFACE s_axilite port=return  bundle=control
-
-    #pragma HLS INTERFACE s_axilite port=input_size1    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size2    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size3    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size4    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size5    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size6    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size7    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size8    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size9    bundle=control
-    #pragma HLS INTERFACE s_axilite port=input_size10   bundle=control
-
-    #pragma HLS INTERFACE s_axilite port=compression_size1  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size2  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size3  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size4  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size5  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size6  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size7  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size8  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size9  bundle=control
-    #pragma HLS INTERFACE s_axilite port=compression_size10 bundle=control   
-
-    #pragma HLS DATAFLOW
-    lzw_compress(input1, output1, input_size1, compression_size1);
-    lzw_compress(input2, output2, input_size2, compression_size2);
-    lzw_compress(input3, output3, input_size3, compression_size3);
-    lzw_compress(input4, output4, input_size4, compression_size4);
-    lzw_compress(input5, output5, input_size5, compression_size5);
-    lzw_compress(input6, output6, input_size6, compression_size6);
-    lzw_compress(input7, output7, input_size7, compression_size7);
-    lzw_compress(input8, output8, input_size8, compression_size8);
-    lzw_compress(input9, output9, input_size9, compression_size9);
-    lzw_compress(input10, output10, input_size10, compression_size10);
+    #pragma HLS INLINE off
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        Burst_write(memory, offsets[i], words[i], blocks[i]);
+    }
+}
+
+void Round_retire(
+    LzwDescriptor jobs[NUMBER_PARALLEL_FUNCTIONS], uint32_t counts[NUMBER_PARALLEL_FUNCTIONS],
+    bool lasts[NUMBER_PARALLEL_FUNCTIONS], uint32_t written[NUMBER_PARALLEL_FUNCTIONS],
+    uint32_t out_bits[NUMBER_PARALLEL_FUNCTIONS], MemoryWord done_blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS],
+    MemoryWord next_blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS],
+    uint32_t offsets[NUMBER_PARALLEL_FUNCTIONS], uint32_t words[NUMBER_PARALLEL_FUNCTIONS]
+) {
+    #pragma HLS INLINE off
+    // Whole words only, the partial last word moves to the other block until the chunk ends.
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        offsets[i] = jobs[i].dst + written[i];
+        words[i] = 0;
+        if (counts[i] == 0) continue;
+        words[i] = lasts[i] ? (out_bits[i] + MEMORY_WORD_BITS - 1) / MEMORY_WORD_BITS : out_bits[i] / MEMORY_WORD_BITS;
+
+        if (lasts[i]) {
+            jobs[i].size_out = written[i] + out_bits[i] / 8;
+        } else {
+            written[i] += words[i] * MEMORY_WORD_BYTES;
+            next_blocks[i][0] = done_blocks[i][words[i]];
+            out_bits[i] -= words[i] * MEMORY_WORD_BITS;
+        }
+    }
+}
+
+#ifndef __SYNTHESIS__
+/*
+ * Cycle model of one round: the read port, the engines and the write port work concurrently, so only
+ * the burst time beyond the slowest engine is on the critical path.
+ */
+static void Model_round(const LzwCycleModel &before, uint32_t slowest) {
+    uint64_t reads = (lzw_model.read_bursts - before.read_bursts) * LZW_MODEL_AXI_LATENCY + lzw_model.read_beats - before.read_beats;
+    uint64_t writes = (lzw_model.write_bursts - before.write_bursts) * LZW_MODEL_AXI_LATENCY + lzw_model.write_beats - before.write_beats;
+    uint64_t bursts = (reads > writes) ? reads : writes;
+    lzw_model.compute_cycles += slowest;
+    lzw_model.burst_cycles += (bursts > slowest) ? bursts - slowest : 0;
+}
+#endif
+
+/**************************  Main Parallel Compression Function Declaration ******************************/
+void top_parallel_lzw(LzwDescriptor *descriptors, MemoryWord *memory_rd, MemoryWord *memory_wr) {
+    #pragma HLS INTERFACE m_axi depth=NUMBER_PARALLEL_FUNCTIONS port=descriptors offset=slave bundle=AXIM_DESC
+    #pragma HLS INTERFACE m_axi depth=MEMORY_DEPTH port=memory_rd offset=slave bundle=AXIM_RD max_read_burst_length=256
+    #pragma HLS INTERFACE m_axi depth=MEMORY_DEPTH port=memory_wr offset=slave bundle=AXIM_WR max_write_burst_length=256
+
+    #pragma HLS INTERFACE s_axilite port=descriptors bundle=control
+    #pragma HLS INTERFACE s_axilite port=memory_rd   bundle=control
+    #pragma HLS INTERFACE s_axilite port=memory_wr   bundle=control
+    #pragma HLS INTERFACE s_axilite port=return      bundle=control
+
+    LzwDescriptor jobs[NUMBER_PARALLEL_FUNCTIONS];
+    LzwEngineState<LZW_CODE_BITS> states[NUMBER_PARALLEL_FUNCTIONS];
+    uint32_t consumed[NUMBER_PARALLEL_FUNCTIONS];      // Input bytes already read
+    uint32_t written[NUMBER_PARALLEL_FUNCTIONS];       // Output bytes already retired
+    uint32_t counts[2][NUMBER_PARALLEL_FUNCTIONS];     // Input bytes of the round held by each input block
+    bool lasts[2][NUMBER_PARALLEL_FUNCTIONS];          // That round ends the chunk
+    uint32_t out_bits[NUMBER_PARALLEL_FUNCTIONS];      // Bits staged in the output block being filled
+    uint32_t write_offsets[NUMBER_PARALLEL_FUNCTIONS]; // Burst of the previous round, written during this one
+    uint32_t write_words[NUMBER_PARALLEL_FUNCTIONS];
+    #pragma HLS ARRAY_PARTITION variable=jobs complete
+    #pragma HLS ARRAY_PARTITION variable=states complete
+    #pragma HLS ARRAY_PARTITION variable=consumed complete
+    #pragma HLS ARRAY_PARTITION variable=written complete
+    #pragma HLS ARRAY_PARTITION variable=counts complete dim=0
+    #pragma HLS ARRAY_PARTITION variable=lasts complete dim=0
+    #pragma HLS ARRAY_PARTITION variable=out_bits complete
+    #pragma HLS ARRAY_PARTITION variable=write_offsets complete
+    #pragma HLS ARRAY_PARTITION variable=write_words complete
+
+    // One dictionary and two pairs of staging blocks per engine, kept on chip across rounds. While the
+    // engines work on the ping blocks, the next round is read into the pong input blocks and the previous
+    // round is written from the pong output blocks, then the roles swap.
+    Dictionary<LZW_CODE_BITS> dictionaries[NUMBER_PARALLEL_FUNCTIONS][LZW_HASH_SIZE];
+    MemoryWord in_ping[NUMBER_PARALLEL_FUNCTIONS][LZW_IN_BLOCK_WORDS];
+    MemoryWord in_pong[NUMBER_PARALLEL_FUNCTIONS][LZW_IN_BLOCK_WORDS];
+    MemoryWord out_ping[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS];
+    MemoryWord out_pong[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS];
+    #pragma HLS ARRAY_PARTITION variable=dictionaries complete dim=1
+    #pragma HLS BIND_STORAGE variable=dictionaries type=ram_2p impl=bram
+    #pragma HLS ARRAY_PARTITION variable=in_ping complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=in_pong complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=out_ping complete dim=1
+    #pragma HLS ARRAY_PARTITION variable=out_pong complete dim=1
+
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        #pragma HLS PIPELINE II=1
+        jobs[i] = descriptors[i];
+        states[i].started = false;
+        states[i].cycles = 0;
+        consumed[i] = 0;
+        written[i] = 0;
+        out_bits[i] = 0;
+        write_words[i] = 0;
+    }
+
+    // The first blocks are read before any engine can start.
+#ifndef __SYNTHESIS__
+    LzwCycleModel before = lzw_model;
+#endif
+    Round_read(memory_rd, jobs, consumed, counts[0], lasts[0], in_ping);
+#ifndef __SYNTHESIS__
+    Model_round(before, 0);
+#endif
+
+    bool busy = true;
+    for (uint32_t round = 0; busy; round++) {
+        #pragma HLS LOOP_TRIPCOUNT max=MEMORY_DEPTH*MEMORY_WORD_BYTES/LZW_BLOCK_SIZE+1
+        uint32_t cur = round % 2;
+#ifndef __SYNTHESIS__
+        before = lzw_model;
+        uint32_t started[NUMBER_PARALLEL_FUNCTIONS];
+        for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) started[i] = states[i].cycles;
+#endif
+        // The three calls touch disjoint blocks, so they are scheduled concurrently.
+        if (cur == 0) {
+            Round_read(memory_rd, jobs, consumed, counts[1], lasts[1], in_pong);
+            Round_compute(states, dictionaries, in_ping, counts[0], lasts[0], out_ping, out_bits);
+            Round_write(memory_wr, write_offsets, write_words, out_pong);
+        } else {
+            Round_read(memory_rd, jobs, consumed, counts[0], lasts[0], in_ping);
+            Round_compute(states, dictionaries, in_pong, counts[1], lasts[1], out_pong, out_bits);
+            Round_write(memory_wr, write_offsets, write_words, out_ping);
+        }
+#ifndef __SYNTHESIS__
+        uint32_t slowest = 0;
+        for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+            if (states[i].cycles - started[i] > slowest) slowest = states[i].cycles - started[i];
+            lzw_model.engine_cycles += states[i].cycles - started[i];
+        }
+        Model_round(before, slowest);
+#endif
+        LZW_MODEL_ADD(rounds, 1);
+
+        // The output blocks of the other half are free again: the round just computed is written next.
+        if (cur == 0) {
+            Round_retire(jobs, counts[0], lasts[0], written, out_bits, out_ping, out_pong, write_offsets, write_words);
+        } else {
+            Round_retire(jobs, counts[1], lasts[1], written, out_bits, out_pong, out_ping, write_offsets, write_words);
+        }
+
+        busy = false;
+        for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+            #pragma HLS UNROLL
+            if (counts[1 - cur][i] > 0 || write_words[i] > 0) busy = true;
+        }
+    }
+
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        #pragma HLS PIPELINE II=1
+        descriptors[i].size_out = (jobs[i].len == 0) ? 0 : jobs[i].size_out;
+        descriptors[i].cycles = states[i].cycles;
+    }
+}
+
+/**************************  Cycle Model Function Declaration ******************************/
+#ifndef __SYNTHESIS__
+void Model_reset(void) {
+    memset(&lzw_model, 0, sizeof(lzw_model));
+}
+
+const LzwCycleModel *Model_get(void) {
+    return &lzw_model;
+}
+
+void Model_print(const LzwCycleModel *model) {
+    uint64_t cycles = model->compute_cycles + model->burst_cycles;
+    double bytes = model->bytes ? (double)model->bytes : 1.0;
+    double engine_bytes = model->engine_bytes ? (double)model->engine_bytes : 1.0;
+
+    printf("Model: %llu bytes in %llu rounds, %llu estimated cycles (%.2f per byte, %.2f per byte per engine)\n",
+           (unsigned long long)model->bytes, (unsigned long long)model->rounds, (unsigned long long)cycles,
+           cycles / bytes, cycles * NUMBER_PARALLEL_FUNCTIONS / bytes);
+    printf("Model: compute %llu cycles, bursts not hidden by the engines %llu cycles (%.1f%%)\n",
+           (unsigned long long)model->compute_cycles, (unsigned long long)model->burst_cycles,
+           cycles ? 100.0 * model->burst_cycles / cycles : 0.0);
+    printf("Model: engines busy %.1f%% of the compute cycles (the rest waits for the slowest engine of the round)\n",
+           model->compute_cycles ? 100.0 * model->engine_cycles / ((double)model->compute_cycles * NUMBER_PARALLEL_FUNCTIONS) : 0.0);
+    printf("Model: %.2f find probes, %.2f add probes, %.2f write iterations per byte, %llu clear iterations, %llu resets\n",
+           model->find_probes / engine_bytes, model->add_probes / engine_bytes, model->write_iterations / engine_bytes,
+           (unsigned long long)model->clear_iterations, (unsigned long long)model->resets);
+    printf("Model: AXI %llu read bursts (%llu beats), %llu write bursts (%llu beats)\n",
+           (unsigned long long)model->read_bursts, (unsigned long long)model->read_beats,
+           (unsigned long long)model->write_bursts, (unsigned long long)model->write_beats);
 }
+#endif
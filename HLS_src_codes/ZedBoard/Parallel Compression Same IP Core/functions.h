@@ -8,40 +8,164 @@
 #include <string.h>
 #include <ap_int.h>
 #include <hls_stream.h>
+#include "lzw_descriptor.h"            // NUMBER_PARALLEL_FUNCTIONS, MEMORY_WORD_BYTES and LzwDescriptor, shared with the host
 
 /************************** Constant Definitions ******************************/
-#define MAX_DICTIONARY_SIZE         4096           // Maximum size of the LZW dictionary (12-bit codes)
-#define INVALID_CODE                0xFFFF         // Used to represent an invalid or non-existent code
-#define NUMBER_PARALLEL_FUNCTIONS   10             // Used to determine the number of functions implemented to run in parallel
+/*
+ * Build-time dictionary geometry of the engines instantiated by top_parallel_lzw.
+ * Smaller dictionaries free BRAM for more engines, larger ones improve the ratio.
+ */
+#ifndef LZW_DICTIONARY_SIZE
+#define LZW_DICTIONARY_SIZE         4096           // Codes allocated before the dictionary is reset (1K-64K)
+#endif
+#ifndef LZW_CODE_BITS
+#define LZW_CODE_BITS               12             // Maximum code width in bits (10-16)
+#endif
+#ifndef LZW_HASH_SIZE
+#define LZW_HASH_SIZE               4096           // Hash table slots (power of two, >= LZW_DICTIONARY_SIZE)
+#endif
+
+/*
+ * Dictionary hash functions, selected at build time with LZW_HASH_FUNCTION, same choices as the HASH
+ * Version (compared by Benchmark_Src_Codes/hash_eval.c). The output does not depend on it, only the
+ * number of probes does.
+ */
+#define LZW_HASH_SHIFT_XOR          0              // hash1/hash2 from shifts and XORs
+#define LZW_HASH_MULTIPLICATIVE     1              // Top bits of key * 2654435761 (one DSP multiply)
+#define LZW_HASH_CRC                2              // CRC-32 of the prefix + extension key (an XOR tree, no DSP)
+
+#ifndef LZW_HASH_FUNCTION
+#define LZW_HASH_FUNCTION           LZW_HASH_CRC
+#endif
+#define CRC32_POLY                  0xEDB88320
+
+#ifndef LZW_BLOCK_SIZE
+#define LZW_BLOCK_SIZE              4096           // Input bytes moved per engine and per round (multiple of 8)
+#endif
+#define MEMORY_DEPTH                8192           // Depth of the memory ports (in words) seen by C/RTL co-simulation
+#define MEMORY_WORD_BITS            (8 * MEMORY_WORD_BYTES)
+#define LZW_ENTRY_BITS              (2 * LZW_CODE_BITS + 8)   // Width of a packed dictionary entry
+#ifndef LZW_MODEL_AXI_LATENCY
+#define LZW_MODEL_AXI_LATENCY       40             // Cycle model: cycles from a burst request to its first beat
+#endif
+/* Output staging of one engine: the unwritten tail of the previous round, then at most one code per input byte plus the last one. */
+#define LZW_OUT_BLOCK_SIZE          (MEMORY_WORD_BYTES + (((LZW_BLOCK_SIZE + 1) * LZW_CODE_BITS + MEMORY_WORD_BITS - 1) / MEMORY_WORD_BITS) * MEMORY_WORD_BYTES)
+/*
+ * The staging blocks hold whole memory words, so each one is a single LZW_*_BLOCK_WORDS x MEMORY_WORD_BITS
+ * memory and one BRAM access moves a whole beat (a byte-partitioned block would take one BRAM per byte lane).
+ */
+#define LZW_IN_BLOCK_WORDS          (LZW_BLOCK_SIZE / MEMORY_WORD_BYTES)
+#define LZW_OUT_BLOCK_WORDS         (LZW_OUT_BLOCK_SIZE / MEMORY_WORD_BYTES)
 
 /**************************** Type Definitions *******************************/
 /**
- * @brief Dictionary entry used for LZW compression.
+ * @brief Dictionary entry used for LZW compression, packed in one word so a hash slot is a single
+ *        BRAM access: prefix code in the low CODE_BITS bits, then the extension byte, then the code.
+ *        Stored codes are always >= 256, so a zero code marks a free slot and no used array is needed.
+ *
+ * @tparam CODE_BITS    Maximum code width in bits.
+ */
+template <int CODE_BITS>
+using Dictionary = ap_uint<2 * CODE_BITS + 8>;
+
+/**
+ * @brief Word of the shared memory ports. Byte k of a word is the byte at address 8 * index + k.
+ */
+typedef ap_uint<MEMORY_WORD_BITS> MemoryWord;
+
+/**
+ * @brief Compression state an engine carries from one round to the next.
+ *
+ * @tparam CODE_BITS    Maximum code width in bits.
+ */
+template <int CODE_BITS>
+struct LzwEngineState {
+    ap_uint<CODE_BITS> prefix;              // Current prefix code
+    ap_uint<CODE_BITS + 1> dictionary_size; // Next code to assign
+    ap_uint<5> bit_count;                   // Current code width
+    bool started;                           // First byte already taken as the prefix
+    uint32_t cycles;                        // Busy cycles so far, counted as loop iterations of the engine
+};
+
+/**
+ * @brief Cycle model of top_parallel_lzw, filled during C simulation only.
+ *        Every pipelined loop is counted at II=1, so the estimate is the sum of the loop iterations on the
+ *        critical path: per round, the slowest of the read bursts of the next round, the slowest engine and
+ *        the write bursts of the previous round, which run concurrently.
  */
 typedef struct {
-    uint16_t prefix_code;  // Code of the previous sequence
-    uint8_t ext_byte;      // New byte to add to the sequence
-    uint16_t code;         // Assigned code for the new sequence
-} Dictionary;
+    uint64_t bytes;              // Input bytes compressed
+    uint64_t engine_bytes;       // Dictionary_find calls (one per input byte after the first of a chunk)
+    uint64_t find_probes;        // Dictionary_find iterations
+    uint64_t add_probes;         // Dictionary_add iterations
+    uint64_t clear_iterations;   // init_dictionary iterations
+    uint64_t write_iterations;   // write_output iterations
+    uint64_t resets;             // Dictionary resets (not counting the clear at the start of a chunk)
+    uint64_t rounds;             // Rounds of top_parallel_lzw (one more than the compute rounds, to drain the writes)
+    uint64_t read_bursts;        // Bursts on memory_rd
+    uint64_t read_beats;         // Words read on memory_rd
+    uint64_t write_bursts;       // Bursts on memory_wr
+    uint64_t write_beats;        // Words written on memory_wr
+    uint64_t compute_cycles;     // Sum over the rounds of the slowest engine
+    uint64_t engine_cycles;      // Sum over the rounds and engines of the busy cycles (the rest of compute_cycles waits)
+    uint64_t burst_cycles;       // Sum over the rounds of the burst cycles beyond the slowest engine
+} LzwCycleModel;
 
 /************************** Helper Function Declarations ******************************/
 /**
- * @brief Initializes the dictionary with single-byte entries.
+ * @brief Packs a prefix + extension pair and its code into a dictionary entry.
+ *
+ * @param prefix        The prefix code.
+ * @param ext           The extension byte.
+ * @param code          Assigned code (0 leaves the entry free, e.g. for a lookup key).
+ *
+ * @return The packed entry.
+ */
+template <int CODE_BITS>
+Dictionary<CODE_BITS> Dictionary_pack(ap_uint<CODE_BITS> prefix, ap_uint<8> ext, ap_uint<CODE_BITS> code);
+
+/**
+ * @brief Initializes the dictionary (marks every hash slot as free).
  *
  * @param dictionary        Pointer to the dictionary.
- * @param dictionary_used   Pointer to a table that indicated if an entry with a certain index is used or not.
  */
-void init_dictionary(Dictionary *dictionary, bool *dictionary_used);
+template <int CODE_BITS, int HASH_SIZE>
+void init_dictionary(Dictionary<CODE_BITS> *dictionary);
 
 /**
  * @brief Reset the dictionary to its initial state.
  *
  * @param dictionary        Pointer to the dictionary.
- * @param dictionary_used   Pointer to a table that indicated if an entry with a certain index is used or not.
- * @param dictionary_size   Pointer to current dictionary size.
- * @param bit_count         Pointer to current code bit width.
+ * @param dictionary_size   Reference to current dictionary size.
+ * @param bit_count         Reference to current code bit width.
  */
-void Dictionary_reset(Dictionary *dictionary, bool *dictionary_used, uint16_t *dictionary_size, uint8_t *bit_count);
+template <int CODE_BITS, int HASH_SIZE>
+void Dictionary_reset(Dictionary<CODE_BITS> *dictionary, ap_uint<CODE_BITS + 1> &dictionary_size, ap_uint<5> &bit_count);
+
+/**
+ * @brief Reports the BRAM36 blocks taken by a depth x width memory, picking the best BRAM36 aspect ratio.
+ *        Used to size NUMBER_PARALLEL_FUNCTIONS: every engine owns a LZW_HASH_SIZE x LZW_ENTRY_BITS dictionary.
+ *
+ * @param depth         Number of words.
+ * @param width         Word width in bits.
+ *
+ * @return Number of BRAM36 blocks.
+ */
+uint32_t bram36_count(uint32_t depth, uint32_t width);
+
+/**
+ * @brief Mixes prefix and extension into 32 bits with the LZW_HASH_FUNCTION hash, hash1/hash2 are its
+ *        top bits except for LZW_HASH_SHIFT_XOR.
+ *
+ * @tparam CODE_BITS    Maximum code width in bits.
+ *
+ * @param prefix        The prefix code.
+ * @param ext           The extension byte.
+ *
+ * @return 32-bit hash.
+ */
+template <int CODE_BITS>
+uint32_t hash_mix(uint32_t prefix, uint32_t ext);
 
 /**
  * @brief Computes hash functions for dictionary indexing.
@@ -51,93 +175,220 @@ void Dictionary_reset(Dictionary *dictionary, bool *dictionary_used, uint16_t *d
  *
  * @return Hash value for dictionary indexing.
  */
-uint32_t hash1(uint16_t prefix, uint8_t ext);
-uint32_t hash2(uint16_t prefix, uint8_t ext);
+template <int CODE_BITS, int HASH_SIZE>
+uint32_t hash1(uint32_t prefix, uint32_t ext);
+template <int CODE_BITS, int HASH_SIZE>
+uint32_t hash2(uint32_t prefix, uint32_t ext);
 
 /**
  * @brief Finds the code for a given prefix + extension entry in the dictionary.
  *
  * @param dictionary            Pointer to the dictionary.
- * @param dictionary_used       Pointer to a table that indicated if an entry with a certain index is used or not.
  * @param prefix                The prefix code.
  * @param ext                   The extension byte.
+ * @param code                  Reference to store the code of the sequence when found.
+ * @param probes                Reference incremented by the number of slots probed.
  *
- * @return The code for the sequence if found, INVALID_CODE otherwise.
+ * @return true if the sequence is in the dictionary, false otherwise.
  */
-uint16_t Dictionary_find(Dictionary *dictionary, bool *dictionary_used, uint16_t prefix, uint8_t ext);
+template <int CODE_BITS, int HASH_SIZE>
+bool Dictionary_find(
+    Dictionary<CODE_BITS> *dictionary,
+    ap_uint<CODE_BITS> prefix, ap_uint<8> ext, ap_uint<CODE_BITS> &code, uint32_t &probes
+);
 
 /**
  * @brief Adds a new prefix + extension to the dictionary.
  *
  * @param dictionary      Pointer to the dictionary.
- * @param dictionary_used Pointer to a table that indicated if an entry with a certain index is used or not.
  * @param prefix          Prefix code.
  * @param ext             Extension byte.
- * @param dictionary_size Pointer to current dictionary size (updated internally).
- * @param bit_count       Pointer to current code bit width.
+ * @param dictionary_size Reference to current dictionary size (updated internally).
+ * @param bit_count       Reference to current code bit width.
+ * @param probes          Reference incremented by the number of slots probed (and cleared on a reset).
  */
+template <int DICT_SIZE, int CODE_BITS, int HASH_SIZE>
 void Dictionary_add(
-    Dictionary *dictionary, bool *dictionary_used,
-    uint16_t prefix, uint8_t ext,
-    uint16_t *dictionary_size, uint8_t *bit_count
+    Dictionary<CODE_BITS> *dictionary,
+    ap_uint<CODE_BITS> prefix, ap_uint<8> ext,
+    ap_uint<CODE_BITS + 1> &dictionary_size, ap_uint<5> &bit_count, uint32_t &probes
 );
 
 /**
- * @brief Writes a code into the output stream using a specific bit width.
+ * @brief Returns one byte of a block of memory words.
+ *
+ * @param block         Block of memory words.
+ * @param index         Byte index in the block.
+ *
+ * @return The byte.
+ */
+ap_uint<8> Block_byte(MemoryWord *block, uint32_t index);
+
+/**
+ * @brief Writes a code into the output buffer using a specific bit width.
+ *        Bits already in the word at *out_index are kept, so a partial word can be carried between blocks.
+ *        The word being filled stays in a register and is stored once per word crossed.
  *
  * @param code           Code to write.
- * @param output         Output stream (FIFO).
+ * @param output         Output buffer.
  * @param bit_count      Current bit width for codes.
- * @param out_index      Reference to current output bit index.
- * @param pending_byte   Reference to byte buffer that stores bits before flushing.
- * @param pending_bits   Reference to current number of bits in pending_byte.
+ * @param out_index      Pointer to current output bit index.
  */
-void write_output(uint16_t code, uint8_t *output, uint8_t bit_count, uint32_t *out_index);
+template <int CODE_BITS>
+void write_output(ap_uint<CODE_BITS> code, MemoryWord *output, ap_uint<5> bit_count, uint32_t *out_index);
+
+/**
+ * @brief Burst-reads count bytes starting at any byte offset of the memory port into a local block.
+ *        The bytes are realigned to the start of the block, two consecutive memory words giving one block word.
+ *
+ * @param memory        Memory port.
+ * @param offset        Byte offset of the first byte.
+ * @param count         Number of bytes (<= LZW_BLOCK_SIZE).
+ * @param block         Local block receiving the bytes.
+ */
+void Burst_read(MemoryWord *memory, uint32_t offset, uint32_t count, MemoryWord block[LZW_IN_BLOCK_WORDS]);
+
+/**
+ * @brief Burst-writes whole words from a local block to a word aligned offset of the memory port.
+ *
+ * @param memory        Memory port.
+ * @param offset        Byte offset of the first word (multiple of MEMORY_WORD_BYTES).
+ * @param words         Number of words.
+ * @param block         Local block holding the words.
+ */
+void Burst_write(MemoryWord *memory, uint32_t offset, uint32_t words, MemoryWord block[LZW_OUT_BLOCK_WORDS]);
+
+/**
+ * @brief Reads the next block of every engine with input left (one burst each, in turn on the read port).
+ *
+ * @param memory        Read port.
+ * @param jobs          Descriptors of the engines.
+ * @param consumed      Input bytes already read per engine, advanced by the block read.
+ * @param counts        Bytes read per engine (0 once its chunk is read).
+ * @param lasts         The block read ends the chunk of the engine.
+ * @param blocks        Input blocks receiving the bytes.
+ */
+void Round_read(
+    MemoryWord *memory, LzwDescriptor jobs[NUMBER_PARALLEL_FUNCTIONS], uint32_t consumed[NUMBER_PARALLEL_FUNCTIONS],
+    uint32_t counts[NUMBER_PARALLEL_FUNCTIONS], bool lasts[NUMBER_PARALLEL_FUNCTIONS],
+    MemoryWord blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_IN_BLOCK_WORDS]
+);
+
+/**
+ * @brief Runs lzw_compress_block on every engine at once.
+ *
+ * @param states        Engine states.
+ * @param dictionaries  Engine dictionaries.
+ * @param in_blocks     Input blocks of the round.
+ * @param counts        Bytes in each input block.
+ * @param lasts         The block ends the chunk of the engine.
+ * @param out_blocks    Output blocks of the round (holding the partial word carried from the previous one).
+ * @param out_bits      Bits staged in each output block.
+ */
+void Round_compute(
+    LzwEngineState<LZW_CODE_BITS> states[NUMBER_PARALLEL_FUNCTIONS],
+    Dictionary<LZW_CODE_BITS> dictionaries[NUMBER_PARALLEL_FUNCTIONS][LZW_HASH_SIZE],
+    MemoryWord in_blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_IN_BLOCK_WORDS], uint32_t counts[NUMBER_PARALLEL_FUNCTIONS],
+    bool lasts[NUMBER_PARALLEL_FUNCTIONS], MemoryWord out_blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS],
+    uint32_t out_bits[NUMBER_PARALLEL_FUNCTIONS]
+);
+
+/**
+ * @brief Writes the words retired by the previous round (one burst each, in turn on the write port).
+ *
+ * @param memory        Write port.
+ * @param offsets       Byte offset of the first word per engine.
+ * @param words         Number of words per engine (0 skips the engine).
+ * @param blocks        Output blocks holding the words.
+ */
+void Round_write(
+    MemoryWord *memory, uint32_t offsets[NUMBER_PARALLEL_FUNCTIONS], uint32_t words[NUMBER_PARALLEL_FUNCTIONS],
+    MemoryWord blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS]
+);
+
+/**
+ * @brief Closes a compute round: picks the words to write next round, records the compressed size of the
+ *        chunks that ended, and moves the partial last word of the others to the output block of the next round.
+ *
+ * @param jobs          Descriptors of the engines (size_out set when the chunk ends).
+ * @param counts        Bytes compressed per engine this round.
+ * @param lasts         The round ended the chunk of the engine.
+ * @param written       Output bytes already retired per engine.
+ * @param out_bits      Bits staged per engine, left with the carried partial word.
+ * @param done_blocks   Output blocks of the round.
+ * @param next_blocks   Output blocks of the next round.
+ * @param offsets       Byte offset of the words to write per engine.
+ * @param words         Number of words to write per engine.
+ */
+void Round_retire(
+    LzwDescriptor jobs[NUMBER_PARALLEL_FUNCTIONS], uint32_t counts[NUMBER_PARALLEL_FUNCTIONS],
+    bool lasts[NUMBER_PARALLEL_FUNCTIONS], uint32_t written[NUMBER_PARALLEL_FUNCTIONS],
+    uint32_t out_bits[NUMBER_PARALLEL_FUNCTIONS], MemoryWord done_blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS],
+    MemoryWord next_blocks[NUMBER_PARALLEL_FUNCTIONS][LZW_OUT_BLOCK_WORDS],
+    uint32_t offsets[NUMBER_PARALLEL_FUNCTIONS], uint32_t words[NUMBER_PARALLEL_FUNCTIONS]
+);
+
+#ifndef __SYNTHESIS__
+/**
+ * @brief Clears the cycle model before a C simulation run.
+ */
+void Model_reset(void);
+
+/**
+ * @brief Returns the cycle model accumulated since the last Model_reset.
+ */
+const LzwCycleModel *Model_get(void);
+
+/**
+ * @brief Prints the cycle model with the estimated cycles per byte.
+ *
+ * @param model         Cycle model to print.
+ */
+void Model_print(const LzwCycleModel *model);
+#endif
 
 /************************** Main Function Declaration ******************************/
 /**
- * @brief LZW compression function for HLS using streaming FIFO interfaces.
- *        Compresses input data from a stream and writes compressed output to another stream.
+ * @brief LZW compression of one block of a chunk for HLS.
+ *        Compresses the block from the state left by the previous block of the same chunk and appends the
+ *        bit-packed codes to the output block. The last block also emits the final prefix and pads to a byte.
  *
- * @param input        Input stream of data bytes.
- * @param output       Output stream for compressed (bit-packed) data.
- * @param input_size   Input data size.
- * @param output_size  Reference to store compressed data size (in bytes).
+ * @tparam DICT_SIZE   Codes allocated before the dictionary is reset (1K-64K).
+ * @tparam CODE_BITS   Maximum code width in bits (10-16), sizes the ap_uint datapaths.
+ * @tparam HASH_SIZE   Hash table slots (power of two, >= DICT_SIZE).
+ *
+ * @param state        Engine state carried between blocks (started = false before the first block).
+ * @param dictionary   Dictionary of the engine, kept between blocks.
+ * @param input        Input block.
+ * @param count        Bytes in the input block.
+ * @param last         This block ends the chunk.
+ * @param output       Output block.
+ * @param out_index    Pointer to the current output bit index in the output block.
  */
-void lzw_compress(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size);
+template <int DICT_SIZE, int CODE_BITS, int HASH_SIZE>
+void lzw_compress_block(
+    LzwEngineState<CODE_BITS> &state, Dictionary<CODE_BITS> *dictionary,
+    MemoryWord *input, uint32_t count, bool last, MemoryWord *output, uint32_t *out_index
+);
 
 /**************************  Main Parallel Compression Function Declaration ******************************/
 /**
  * @brief Top-level parallel LZW compression function for HLS.
- *        Splits the input buffer into three segments and compresses them in parallel.
- *
- * @param inputX                Pointer to X input data buffer.
- * @param input_sizeX           Size of the X input buffer.
- * @param outputX               Pointer to the X output buffer.
- * @param compression_sizeX     Pointer to store compressed size of the X segment.
- */
-void top_parallel_lzw(
-    uint8_t* input1, int input_size1,
-    uint8_t* input2, int input_size2,
-    uint8_t* input3, int input_size3,
-    uint8_t* input4, int input_size4,
-    uint8_t* input5, int input_size5,
-    uint8_t* input6, int input_size6,
-    uint8_t* input7, int input_size7,
-    uint8_t* input8, int input_size8,
-    uint8_t* input9, int input_size9,
-    uint8_t* input10, int input_size10,
-    uint8_t* output1, uint32_t* compression_size1,
-    uint8_t* output2, uint32_t* compression_size2,
-    uint8_t* output3, uint32_t* compression_size3,
-    uint8_t* output4, uint32_t* compression_size4,
-    uint8_t* output5, uint32_t* compression_size5,
-    uint8_t* output6, uint32_t* compression_size6,
-    uint8_t* output7, uint32_t* compression_size7,
-    uint8_t* output8, uint32_t* compression_size8,
-    uint8_t* output9, uint32_t* compression_size9,
-    uint8_t* output10, uint32_t* compression_size10
-);
+ *        Fetches one descriptor per engine and runs the NUMBER_PARALLEL_FUNCTIONS engines in parallel,
+ *        each one compressing its own chunk. The compressed sizes are written back into the descriptors.
+ *        The engines never touch DDR: one LZW_BLOCK_SIZE burst per engine fills the local input blocks over
+ *        memory_rd, the engines compress them, and the whole words produced are burst-written over memory_wr.
+ *        The blocks are double buffered, so the reads of round N+1 and the writes of round N-1 overlap the
+ *        compression of round N. The number of engines is thus independent of the number of ports.
+ *        The engines run in lockstep: a round lasts as long as its slowest engine, so an engine given a chunk
+ *        that compresses with fewer probes (or that ended) waits for the others. Chunks of different nature
+ *        cost up to that difference; Model_print reports the share of the engine cycles actually busy.
+ *
+ * @param descriptors   Pointer to the array of NUMBER_PARALLEL_FUNCTIONS job descriptors.
+ * @param memory_rd     Base of the memory window the descriptor offsets refer to, read port.
+ * @param memory_wr     Same window, write port (the host sets both to the same base).
+ */
+void top_parallel_lzw(LzwDescriptor *descriptors, MemoryWord *memory_rd, MemoryWord *memory_wr);
 
 
 #endif
\ No newline at end of file
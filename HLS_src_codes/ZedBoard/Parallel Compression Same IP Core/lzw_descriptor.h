@@ -0,0 +1,33 @@
+#ifndef LZW_DESCRIPTOR_H
+#define LZW_DESCRIPTOR_H
+
+/*
+ * Interface of top_parallel_lzw shared by the HLS core and the host application, in plain C so both
+ * compilers read the same file: changing the number of engines is a rebuild of the two, not an edit of each.
+ */
+#include <stdint.h>
+
+/************************** Constant Definitions ******************************/
+/* 10 engines fit the XC7Z020: each takes 4 BRAM36 of dictionary and 2 x (1 + 2) of burst blocks, 100 of the 140. */
+#ifndef NUMBER_PARALLEL_FUNCTIONS
+#define NUMBER_PARALLEL_FUNCTIONS   10             // Used to determine the number of functions implemented to run in parallel
+#endif
+#define MEMORY_WORD_BYTES           8              // Width of the shared memory ports in bytes
+
+/**************************** Type Definitions *******************************/
+/**
+ * @brief Job descriptor of one engine, prepared by the host in DDR.
+ *        src and dst are byte offsets from the memory ports of top_parallel_lzw; the host leaves
+ *        those ports at 0, so they are plain physical addresses.
+ *        The engine writes whole memory words: dst must be MEMORY_WORD_BYTES aligned and the output
+ *        buffer rounded up to a multiple of MEMORY_WORD_BYTES. src has no alignment constraint.
+ */
+typedef struct {
+    uint32_t src;          // Offset of the input chunk
+    uint32_t len;          // Input chunk size in bytes
+    uint32_t dst;          // Offset of the output buffer (2 * len bytes, rounded up to a word)
+    uint32_t size_out;     // Compressed size in bytes, written back by the engine
+    uint32_t cycles;       // Busy cycles of the engine, written back by the engine
+} LzwDescriptor;
+
+#endif
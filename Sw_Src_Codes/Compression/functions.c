@@ -1,4 +1,5 @@
 #include "functions.h"
+#include "lzw_probes.h"                 // User_level_application/Common
 
 // -------------------------------------------------------------------------------------
 /*
@@ -15,15 +16,27 @@ size_t bitstream_index = 0;
 
 int bit_count = 8;
 
+#ifndef LZW_HOSTED
 FIL fil;
 FATFS fatfs;
 static const TCHAR *Path = "0:";
 static char finput[32] = "test.txt";
 static char foutput[32] = "inputd.bin";
+#endif
 
 uint8_t data[100000] = {0};
 size_t data_len = 0;
 
+uint32_t input_crc = 0;
+uint32_t output_crc = 0;
+
+#ifdef LZW_STATS
+LzwStats lzw_stats;
+#define STATS(statement) statement
+#else
+#define STATS(statement)
+#endif
+
 
 // -------------------------------------------------------------------------------------
 /*
@@ -31,8 +44,35 @@ size_t data_len = 0;
  */
 // -------------------------------------------------------------------------------------
 
+static uint32_t Crc32_update(uint32_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (int i = 0; i < 8; i++)
+        crc = (crc & 1) ? (crc >> 1) ^ CRC32_POLY : crc >> 1;
+    return crc;
+}
+
+#ifdef LZW_STATS
+static void count_probes(uint64_t histogram[LZW_STATS_PROBE_BINS], uint64_t *total, uint32_t probes) {
+    histogram[(probes < LZW_STATS_PROBE_BINS) ? probes - 1 : LZW_STATS_PROBE_BINS - 1]++;
+    *total += probes;
+}
+
+static void count_width(uint32_t input_offset, int width) {
+    if (lzw_stats.timeline_count < LZW_STATS_TIMELINE) {
+        lzw_stats.timeline[lzw_stats.timeline_count].input_offset = input_offset;
+        lzw_stats.timeline[lzw_stats.timeline_count].bit_count = (uint8_t)width;
+        lzw_stats.timeline_count++;
+    } else {
+        lzw_stats.timeline_dropped++;
+    }
+}
+#endif
+
 void Dictionary_init(void) {
+    // Free slots hold INVALID_CODE as prefix, so Dictionary_find never matches them or a previous run.
+    memset(dictionary, 0xFF, sizeof(dictionary));
     memset(dictionary_used, 0, sizeof(dictionary_used));
+    dict_size_actual = 0;
     for (uint16_t i = 0; i < 256 ; i++) {
         dictionary[i].code = i;
         dictionary[i].prefix_code = INVALID_CODE;
@@ -43,21 +83,40 @@ void Dictionary_init(void) {
 }
 
 uint32_t hash(uint16_t prefix, uint8_t ext) {
+#if LZW_HASH_FUNCTION == LZW_HASH_SHIFT_XOR
     return ((prefix << 5) ^ ext) % MAX_DICT_SIZE;
+#else
+    uint32_t key = ((uint32_t)ext << 12) | prefix;
+#if LZW_HASH_FUNCTION == LZW_HASH_CRC
+    for (int i = 0; i < 20; i++)
+        key = (key & 1) ? (key >> 1) ^ CRC32_POLY : key >> 1;
+#else
+    key *= 2654435761u;
+#endif
+    return key >> 20;
+#endif
 }
 
 uint16_t Dictionary_find(uint16_t prefix, uint8_t ext) {
     uint32_t h = hash(prefix, ext);
     for (uint32_t i = 0; i < MAX_DICT_SIZE; i++) {
         uint32_t idx = (h + i) % MAX_DICT_SIZE;
-        if (dictionary[idx].prefix_code == prefix && dictionary[idx].ext_byte == ext)
+        if (dictionary[idx].prefix_code == prefix && dictionary[idx].ext_byte == ext) {
+            STATS(count_probes(lzw_stats.find_histogram, &lzw_stats.find_probes, i + 1));
+            STATS(lzw_stats.hits++);
             return dictionary[idx].code;
+        }
     }
+    STATS(count_probes(lzw_stats.find_histogram, &lzw_stats.find_probes, MAX_DICT_SIZE));
+    STATS(lzw_stats.misses++);
     return INVALID_CODE;
 }
 
 void Dictionary_add(uint16_t prefix, uint8_t ext) {
-    if (dict_size_actual >= MAX_DICT_SIZE) return;
+    if (dict_size_actual >= MAX_DICT_SIZE) {
+        STATS(lzw_stats.full_skips++);
+        return;
+    }
     if(dict_size_actual >= (1u << bit_count) && bit_count< (int)log2(MAX_DICT_SIZE)) bit_count++;
 
     uint32_t h = hash(prefix, ext);
@@ -69,6 +128,7 @@ void Dictionary_add(uint16_t prefix, uint8_t ext) {
             dictionary[idx].code = dict_size_actual;
             dictionary_used[idx] = true;
             dict_size_actual++;
+            STATS(count_probes(lzw_stats.add_histogram, &lzw_stats.add_probes, i + 1));
             return;
         }
     }
@@ -79,14 +139,35 @@ void write_to_bitstream(uint16_t code) {
         bool bit = (code >> i) & 1;
         bitstream[bitstream_index / 8] |= (bit << (7 - (bitstream_index % 8)));
         bitstream_index++;
+        if (bitstream_index % 8 == 0) output_crc = Crc32_update(output_crc, bitstream[bitstream_index / 8 - 1]);
     }
+    STATS(lzw_stats.codes++);
+    STATS(lzw_stats.codes_per_width[bit_count]++);
 }
 
 void compress() {
+    // Fresh bitstream, so that compress() can run again on new data after Dictionary_init().
+    memset(bitstream, 0, (bitstream_index + 7) / 8);
+    bitstream_index = 0;
+    bit_count = 8;
+    STATS(memset(&lzw_stats, 0, sizeof(lzw_stats)));
+    STATS(lzw_stats.input_bytes = data_len);
+
+    // An empty input has CRC 0 and so has its empty output, as in the HLS core.
+    input_crc = 0;
+    output_crc = 0;
     if (data_len == 0) return;
+    LZW_PROBE3(job_submit, (uintptr_t)data, LZW_PROBE_COMPRESS, data_len);
+    STATS(count_width(0, bit_count));
+
+    input_crc = Crc32_update(0xFFFFFFFF, data[0]);
+    output_crc = 0xFFFFFFFF;
 
     if (data_len == 1) {
         write_to_bitstream(data[0]);
+        input_crc ^= 0xFFFFFFFF;
+        output_crc ^= 0xFFFFFFFF;
+        LZW_PROBE4(job_complete, (uintptr_t)data, LZW_PROBE_COMPRESS, data_len, (bitstream_index + 7) / 8);
         return;
     }
 
@@ -95,12 +176,15 @@ void compress() {
 
     for (size_t i = 1; i < data_len; i++) {
         ext = data[i];
+        input_crc = Crc32_update(input_crc, ext);
         uint16_t code = Dictionary_find(prefix, ext);
         if (code != INVALID_CODE) {
             prefix = code;
         } else {
             write_to_bitstream(prefix);
+            STATS(int previous_bit_count = bit_count);
             Dictionary_add(prefix, ext);
+            STATS(if (bit_count != previous_bit_count) count_width((uint32_t)i, bit_count));
             prefix = ext;
         }
     }
@@ -109,7 +193,12 @@ void compress() {
     while (bitstream_index % 8 != 0) {
         bitstream[bitstream_index / 8] |= (0 << (7 - (bitstream_index % 8)));
         bitstream_index++;
+        if (bitstream_index % 8 == 0) output_crc = Crc32_update(output_crc, bitstream[bitstream_index / 8 - 1]);
     }
+
+    input_crc ^= 0xFFFFFFFF;
+    output_crc ^= 0xFFFFFFFF;
+    LZW_PROBE4(job_complete, (uintptr_t)data, LZW_PROBE_COMPRESS, data_len, bitstream_index / 8);
 }
 
 void print_bitstream(void) {
@@ -133,7 +222,31 @@ void Dictionary_print(void) {
     }
 }
 
+#ifdef LZW_STATS
+void Lzw_stats_print(const LzwStats *stats) {
+    uint64_t lookups = stats->hits + stats->misses;
+    uint64_t inserts = 0;
+    for (int b = 0; b < LZW_STATS_PROBE_BINS; b++) inserts += stats->add_histogram[b];
+
+    printf("\nDictionary statistics: %llu bytes, %llu codes\n", (unsigned long long)stats->input_bytes,
+           (unsigned long long)stats->codes);
+    printf("Lookups: %llu hits, %llu misses, %.2f slots per lookup\n", (unsigned long long)stats->hits,
+           (unsigned long long)stats->misses, lookups ? (double)stats->find_probes / lookups : 0.0);
+    printf("Inserts: %llu, %.2f slots per insert, %llu skipped (dictionary full)\n", (unsigned long long)inserts,
+           inserts ? (double)stats->add_probes / inserts : 0.0, (unsigned long long)stats->full_skips);
+    printf("Slots per lookup:");
+    for (int b = 0; b < LZW_STATS_PROBE_BINS; b++)
+        printf(" %s%d:%llu", b == LZW_STATS_PROBE_BINS - 1 ? ">=" : "", b + 1, (unsigned long long)stats->find_histogram[b]);
+    printf("\nCodes per width:");
+    for (int w = 8; w <= 12; w++) printf(" %d:%llu", w, (unsigned long long)stats->codes_per_width[w]);
+    printf("\nWidth changes (input byte -> bits):");
+    for (uint32_t t = 0; t < stats->timeline_count; t++)
+        printf(" %lu->%u", (unsigned long)stats->timeline[t].input_offset, stats->timeline[t].bit_count);
+    printf("\n");
+}
+#endif
 
+#ifndef LZW_HOSTED
 int WriteSD(void){
     FRESULT Res;
     UINT NumBytesWritten;
@@ -196,3 +309,4 @@ int ReadSD(void){
     return XST_SUCCESS;
 }
 
+#endif
@@ -2,19 +2,36 @@
 #define FUNCTION_H
 
 #include <stdlib.h>
+#ifndef LZW_HOSTED
 #include "ff.h"
 #include "xil_cache.h"
+#endif
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#ifndef LZW_HOSTED
 #include <xstatus.h>
+#else
+/* Linux build (Benchmark_Src_Codes): no SD card, the caller fills data and data_len */
+#define XST_SUCCESS 0
+#define XST_FAILURE 1
+#endif
 
 #define MAX_DICT_SIZE 4096
 #define INVALID_CODE 0xFFFF
 #define INVALID_SYMBOL 0xFF
+#define CRC32_POLY 0xEDB88320       // Same CRC-32 as the in-line CRCs of the HLS core
+
+/* Dictionary hash, selected at build time with LZW_HASH_FUNCTION as in the HLS core (see Benchmark_Src_Codes/hash_eval.c) */
+#define LZW_HASH_SHIFT_XOR 0        // ((prefix << 5) ^ ext) % MAX_DICT_SIZE
+#define LZW_HASH_MULTIPLICATIVE 1   // Top 12 bits of key * 2654435761
+#define LZW_HASH_CRC 2              // Top 12 bits of the CRC-32 of the 20-bit key
+#ifndef LZW_HASH_FUNCTION
+#define LZW_HASH_FUNCTION LZW_HASH_MULTIPLICATIVE
+#endif
 
 // ------------------------------------------------------------------------------------
 /*
@@ -24,6 +41,8 @@
 
 extern uint8_t data[100000];
 extern size_t data_len;
+extern uint32_t input_crc;          // CRC-32 of data, computed by compress() as it reads
+extern uint32_t output_crc;         // CRC-32 of the bitstream, computed as its bytes complete
 
 typedef struct {
     uint16_t prefix_code;
@@ -31,6 +50,38 @@ typedef struct {
     uint16_t code;
 } Dictionary;
 
+#ifdef LZW_STATS
+/*
+ * Table behaviour of the last compress(), collected only in builds with LZW_STATS. This compressor never
+ * resets its dictionary: once it is full, inserts are skipped and counted in full_skips.
+ */
+#define LZW_STATS_PROBE_BINS 16     // Slots visited 1 to 15, the last bin counts 16 and more
+#define LZW_STATS_TIMELINE 256      // Code-width changes kept, later ones are only counted
+
+typedef struct {
+    uint32_t input_offset;          // Input byte at which the width changed
+    uint8_t bit_count;              // Code width from there on
+} LzwWidthChange;
+
+typedef struct {
+    uint64_t input_bytes;
+    uint64_t codes;                                 // Codes written
+    uint64_t hits;                                  // Lookups that found the string
+    uint64_t misses;                                // Lookups that did not (one code written each)
+    uint64_t find_probes;                           // Slots visited by all lookups
+    uint64_t add_probes;                            // Slots visited by all inserts
+    uint64_t find_histogram[LZW_STATS_PROBE_BINS];  // Lookups by slots visited
+    uint64_t add_histogram[LZW_STATS_PROBE_BINS];   // Inserts by slots visited
+    uint64_t full_skips;                            // Inserts skipped, dictionary full
+    uint64_t codes_per_width[13];                   // Codes written at each width, indexed by bits
+    uint32_t timeline_count;
+    uint32_t timeline_dropped;
+    LzwWidthChange timeline[LZW_STATS_TIMELINE];
+} LzwStats;
+
+extern LzwStats lzw_stats;
+#endif
+
 // ------------------------------------------------------------------------------------
 /*
  *                                      Functions
@@ -45,6 +96,9 @@ void write_to_bitstream(uint16_t code);
 void compress();
 void print_bitstream(void) ;
 void Dictionary_print(void);
+#ifdef LZW_STATS
+void Lzw_stats_print(const LzwStats *stats);
+#endif
 int WriteSD(void);
 int ReadSD(void);
 
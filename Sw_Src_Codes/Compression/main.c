@@ -11,12 +11,16 @@ int main(void){
 
     compress();
     print_bitstream();
+    printf("CRC-32: input %08lx, output %08lx\n", (unsigned long)input_crc, (unsigned long)output_crc);
 
     status = WriteSD();
     if (status != XST_SUCCESS)
         printf("WriteSD failed\n");
 
     Dictionary_print();
+#ifdef LZW_STATS
+    Lzw_stats_print(&lzw_stats);
+#endif
     printf("Program Ended\n");
     return 0;
 }
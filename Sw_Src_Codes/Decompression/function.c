@@ -1,8 +1,11 @@
 #include "function.h"
+#include "lzw_probes.h"                 // User_level_application/Common
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#ifndef LZW_HOSTED
 #include <xil_printf.h>
+#endif
 
 // -------------------------------------------------------------------------------------
 /*
@@ -17,11 +20,13 @@ uint8_t output[MAX_DICT_SIZE * 12] = {0};
 size_t output_index = 0;
 size_t bit_count = 8;
 
+#ifndef LZW_HOSTED
 FIL fil;
 FATFS fatfs;
 static const TCHAR *Path = "0:";
 static char finput[32] = "inputd.bin";
 static char foutput[32] = "output.txt";
+#endif
 
 uint8_t data[100000] = {0};
 size_t data_len = 0;
@@ -29,6 +34,8 @@ size_t data_len = 0;
 size_t bit_position = 0;
 size_t byte_position = 0;
 
+uint32_t output_crc = 0;
+
 // -------------------------------------------------------------------------------------
 /*
  *                                      Functions
@@ -36,6 +43,12 @@ size_t byte_position = 0;
 // -------------------------------------------------------------------------------------
 
 void Dictionary_init(void) {
+    // Fresh decoder state, so that decompress() can run again on new data.
+    dict_size_actual = 0;
+    output_index = 0;
+    bit_count = 8;
+    bit_position = 0;
+    byte_position = 0;
     for (uint16_t i = 0; i < 256; i++) {
         dictionary[i].code = i;
         dictionary[i].sequence[0] = (uint8_t)i;
@@ -63,6 +76,7 @@ void Dictionary_add(const uint8_t *sequence, uint16_t seq_len) {
     dict_size_actual++;
 }
 
+#ifndef LZW_HOSTED
 int ReadSD(void){
     FRESULT Res;
     UINT NumBytesRead;
@@ -120,6 +134,7 @@ int WriteSD(void){
 
     return XST_SUCCESS; 
 }
+#endif
 
 
 uint16_t ReadCode(void) {
@@ -145,6 +160,7 @@ void decompress(void){
     uint8_t new_sequence[MAX_SEQUENCE_LENGTH] = {0};
     size_t len = data_len*8;
 
+    LZW_PROBE3(job_submit, (uintptr_t)data, LZW_PROBE_DECOMPRESS, data_len);
     uint16_t first_code = ReadCode();
     Dictionary *entry = Dictionary_find(first_code);
 
@@ -155,16 +171,14 @@ void decompress(void){
         output_index += prev_length;
     }
     else {
+        LZW_PROBE4(job_complete, (uintptr_t)data, LZW_PROBE_DECOMPRESS, data_len, 0);
         return;
     }
+    len -= bit_count;
     bit_count++;
 
-
-    while(len > bit_count  && len <= data_len*8){
-
-        if (dict_size_actual >= (1 << bit_count) && bit_count < 12) 
-            bit_count++;
-
+    // Codes until the padding, which is shorter than a code (at most 7 bits).
+    while(len >= bit_count){
         uint16_t curr_code = ReadCode();
         Dictionary *entry = Dictionary_find(curr_code);
         const uint8_t *curr_sequence;
@@ -193,11 +207,24 @@ void decompress(void){
 
         memcpy(prev_sequence, curr_sequence, curr_length);
         prev_length = curr_length;
-        len -= bit_count;        
+        len -= bit_count;
+
+        if (dict_size_actual >= (1 << bit_count) && bit_count < 12)
+            bit_count++;
     }
-    if (output[output_index-1] == 0){
-        output_index--;
+
+    output_crc = Crc32(output, output_index);
+    LZW_PROBE4(job_complete, (uintptr_t)data, LZW_PROBE_DECOMPRESS, data_len, output_index);
+}
+
+uint32_t Crc32(const uint8_t *buffer, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= buffer[i];
+        for (int j = 0; j < 8; j++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
     }
+    return crc ^ 0xFFFFFFFF;
 }
 
 void Dictionary_print(void) {
@@ -1,7 +1,15 @@
 #ifndef FUNCTION_H
 #define FUNCTION_H
 
+#ifndef LZW_HOSTED
 #include "ff.h"
+#else
+/* Linux build (Benchmark_Src_Codes): no SD card, the caller fills data and data_len */
+#include <stdint.h>
+#define XST_SUCCESS 0
+#define XST_FAILURE 1
+#endif
+#include <stddef.h>
 #include <stdio.h>
 
 #define MAX_SEQUENCE_LENGTH 256
@@ -19,6 +27,9 @@
 extern uint8_t data[100000];
 extern size_t data_len;
 extern size_t bit_count;
+extern uint32_t output_crc;         // CRC-32 of the decoded data, set by decompress()
+extern uint8_t output[];            // Decoded data, output_index bytes
+extern size_t output_index;
 
 
 typedef struct {
@@ -36,10 +47,15 @@ typedef struct {
 void Dictionary_init();
 Dictionary* Dictionary_find(uint16_t code);
 void Dictionary_add(const uint8_t *sequence, uint16_t seq_len);
+#ifndef LZW_HOSTED
 int ReadSD(void);
+#endif
 uint16_t ReadCode(void);
 void decompress(void);
+#ifndef LZW_HOSTED
 int WriteSD(void);
+#endif
 void Dictionary_print(void);
+uint32_t Crc32(const uint8_t *buffer, size_t length);
 
 #endif
\ No newline at end of file
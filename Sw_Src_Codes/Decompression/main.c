@@ -11,6 +11,7 @@ int main(void){
     }
     
     decompress();
+    printf("Decoded CRC-32: %08lx\n", (unsigned long)output_crc);
     
     status = WriteSD();
     if (status != XST_SUCCESS)
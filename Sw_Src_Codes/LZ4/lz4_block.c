@@ -0,0 +1,165 @@
+#include "lz4_block.h"
+#include <string.h>
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Helper functions
+ */
+// -------------------------------------------------------------------------------------
+
+static uint32_t read32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t lz4_hash(uint32_t seq) {
+    return (seq * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+/* Writes the 255-byte extension of a length that did not fit in its token nibble */
+static int put_length(uint8_t *dst, int out, int dst_capacity, uint32_t length) {
+    while (length >= 255) {
+        if (out >= dst_capacity) return -1;
+        dst[out++] = 255;
+        length -= 255;
+    }
+    if (out >= dst_capacity) return -1;
+    dst[out++] = (uint8_t)length;
+    return out;
+}
+
+/* Writes one sequence; a zero match_length marks the last, literal-only sequence */
+static int put_sequence(uint8_t *dst, int out, int dst_capacity, const uint8_t *literals, uint32_t literal_length,
+                        uint32_t offset, uint32_t match_length) {
+    uint32_t ml_code = match_length ? match_length - LZ4_MIN_MATCH : 0;
+
+    if (out >= dst_capacity) return -1;
+    dst[out++] = (uint8_t)(((literal_length < 15 ? literal_length : 15) << 4) | (ml_code < 15 ? ml_code : 15));
+    if (literal_length >= 15 && (out = put_length(dst, out, dst_capacity, literal_length - 15)) < 0) return -1;
+
+    if ((uint32_t)(dst_capacity - out) < literal_length) return -1;
+    memcpy(dst + out, literals, literal_length);
+    out += literal_length;
+
+    if (match_length == 0) return out;
+    if (dst_capacity - out < 2) return -1;
+    dst[out++] = (uint8_t)offset;
+    dst[out++] = (uint8_t)(offset >> 8);
+    if (ml_code >= 15 && (out = put_length(dst, out, dst_capacity, ml_code - 15)) < 0) return -1;
+    return out;
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// -------------------------------------------------------------------------------------
+
+uint32_t lz4_crc32(uint32_t crc, const uint8_t *data, int len) {
+    // Nibble table: 16 words, cheap enough for the bare-metal builds.
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+    crc = ~crc;
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ table[crc & 15];
+        crc = (crc >> 4) ^ table[crc & 15];
+    }
+    return ~crc;
+}
+
+int lz4_compress_block(const uint8_t *src, int src_len, uint8_t *dst, int dst_capacity, uint32_t table[LZ4_TABLE_SIZE]) {
+    // Positions + 1, so that 0 marks an empty slot.
+    uint32_t anchor = 0;
+    uint32_t pos = 0;
+    int out = 0;
+
+    // Even an empty input needs the token of its last sequence: decoders reject a zero-byte block.
+    if (src_len < 0) return -1;
+    memset(table, 0, LZ4_TABLE_SIZE * sizeof(table[0]));
+
+    if (src_len > LZ4_MFLIMIT) {
+        uint32_t mflimit = (uint32_t)src_len - LZ4_MFLIMIT;
+        uint32_t matchlimit = (uint32_t)src_len - LZ4_LAST_LITERALS;
+
+        // Greedy parse with one table probe per position, as in the HLS engine.
+        while (pos <= mflimit) {
+            uint32_t seq = read32(src + pos);
+            uint32_t h = lz4_hash(seq);
+            uint32_t candidate = table[h];
+            table[h] = pos + 1;
+
+            if (candidate == 0 || pos - (candidate - 1) > LZ4_MAX_DISTANCE || read32(src + candidate - 1) != seq) {
+                pos++;
+                continue;
+            }
+
+            uint32_t match = candidate - 1;
+            uint32_t match_length = LZ4_MIN_MATCH;
+            while (pos + match_length < matchlimit && src[match + match_length] == src[pos + match_length]) match_length++;
+
+            out = put_sequence(dst, out, dst_capacity, src + anchor, pos - anchor, pos - match, match_length);
+            if (out < 0) return -1;
+            pos += match_length;
+            anchor = pos;
+        }
+    }
+
+    return put_sequence(dst, out, dst_capacity, src + anchor, (uint32_t)src_len - anchor, 0, 0);
+}
+
+int lz4_decompress_block(const uint8_t *src, int src_len, uint8_t *dst, int dst_capacity) {
+    int in = 0;
+    int out = 0;
+
+    if (src_len <= 0) return 0;
+
+    while (in < src_len) {
+        uint8_t token = src[in++];
+
+        uint32_t literal_length = token >> 4;
+        if (literal_length == 15) {
+            uint8_t b;
+            do {
+                if (in >= src_len) return -1;
+                b = src[in++];
+                literal_length += b;
+            } while (b == 255);
+        }
+        if ((uint32_t)(src_len - in) < literal_length || (uint32_t)(dst_capacity - out) < literal_length) return -1;
+        memcpy(dst + out, src + in, literal_length);
+        in += literal_length;
+        out += literal_length;
+
+        // The last sequence ends right after its literals.
+        if (in == src_len) break;
+
+        if (src_len - in < 2) return -1;
+        uint32_t offset = (uint32_t)src[in] | ((uint32_t)src[in + 1] << 8);
+        in += 2;
+        if (offset == 0 || offset > (uint32_t)out) return -1;
+
+        uint32_t match_length = (token & 15) + LZ4_MIN_MATCH;
+        if ((token & 15) == 15) {
+            uint8_t b;
+            do {
+                if (in >= src_len) return -1;
+                b = src[in++];
+                match_length += b;
+            } while (b == 255);
+        }
+        if ((uint32_t)(dst_capacity - out) < match_length) return -1;
+
+        // Overlapping copies (offset < match_length) repeat the last offset bytes, so copy forward.
+        const uint8_t *match = dst + out - offset;
+        if (offset >= match_length) {
+            memcpy(dst + out, match, match_length);
+        } else {
+            for (uint32_t i = 0; i < match_length; i++) dst[out + i] = match[i];
+        }
+        out += match_length;
+    }
+
+    return out;
+}
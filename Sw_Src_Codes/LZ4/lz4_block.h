@@ -0,0 +1,72 @@
+#ifndef LZ4_BLOCK_H
+#define LZ4_BLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * LZ4 block format (no frame header): sequences of
+ *   token (literal length << 4 | match length - 4), literal length extension, literals,
+ *   2-byte little-endian offset, match length extension,
+ * the last sequence holding literals only. Plain C with no platform headers, so the same
+ * files build for the ARM cores and for x86.
+ *
+ * The compressor makes the same choices as the LZ4 engine of the HLS hash core, so both produce
+ * identical blocks for the same input. The constants below must match that core.
+ */
+#define LZ4_HASH_BITS       12                  // Match table of 4096 positions
+#define LZ4_TABLE_SIZE      (1 << LZ4_HASH_BITS)
+#define LZ4_WINDOW_SIZE     16384               // History kept on chip by the HLS engine
+#define LZ4_MAX_DISTANCE    (LZ4_WINDOW_SIZE - 4)
+#define LZ4_MIN_MATCH       4
+#define LZ4_LAST_LITERALS   5                   // The block always ends with at least 5 literals
+#define LZ4_MFLIMIT         12                  // No match starts in the last 12 bytes
+
+/* Worst case compressed size of an input of n bytes */
+#define LZ4_COMPRESS_BOUND(n) ((n) + (n) / 255 + 16)
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// ------------------------------------------------------------------------------------
+
+/**
+ * @brief Compresses src into one LZ4 block.
+ *        The match table is the caller's (16 KB, too large for the default bare-metal stack), so calls
+ *        with different tables can run concurrently.
+ *
+ * @param src           Input buffer.
+ * @param src_len       Input size in bytes (0 gives the one-byte block 0x00, an empty last sequence).
+ * @param dst           Output buffer.
+ * @param dst_capacity  Output buffer size, LZ4_COMPRESS_BOUND(src_len) always fits.
+ * @param table         Match table scratch of LZ4_TABLE_SIZE entries, cleared by the call.
+ *
+ * @return Compressed size in bytes, or -1 if dst is too small or src_len is negative.
+ */
+int lz4_compress_block(const uint8_t *src, int src_len, uint8_t *dst, int dst_capacity, uint32_t table[LZ4_TABLE_SIZE]);
+
+/**
+ * @brief Decompresses one LZ4 block. Every length and offset is checked against both buffers.
+ *
+ * @param src           Compressed block.
+ * @param src_len       Compressed size in bytes.
+ * @param dst           Output buffer.
+ * @param dst_capacity  Output buffer size.
+ *
+ * @return Decompressed size in bytes, or -1 if the block is malformed or dst is too small.
+ */
+int lz4_decompress_block(const uint8_t *src, int src_len, uint8_t *dst, int dst_capacity);
+
+/**
+ * @brief CRC-32 (IEEE, the zlib crc32) of a buffer, the value the HLS engines report for their input and output.
+ *
+ * @param crc           CRC of the data before this buffer, 0 to start.
+ * @param data          Buffer.
+ * @param len           Buffer size in bytes.
+ *
+ * @return CRC of the data up to the end of this buffer.
+ */
+uint32_t lz4_crc32(uint32_t crc, const uint8_t *data, int len);
+
+#endif
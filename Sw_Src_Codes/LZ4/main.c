@@ -0,0 +1,58 @@
+#include "lz4_block.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Round trip of a file through the LZ4 block codec: lz4 <file>.
+ * With no argument a built-in log excerpt is used, so the same program runs bare-metal.
+ */
+static const char sample[] =
+    "2024-05-02 10:00:01 INFO  lzw_compress job 17 done, 4096 -> 2311 bytes\n"
+    "2024-05-02 10:00:01 INFO  lzw_compress job 18 done, 4096 -> 2298 bytes\n"
+    "2024-05-02 10:00:02 WARN  lzw_compress job 19 ring full, retrying\n"
+    "2024-05-02 10:00:02 INFO  lzw_compress job 19 done, 4096 -> 2320 bytes\n";
+
+int main(int argc, char **argv) {
+    uint8_t *input = (uint8_t *)sample;
+    int input_len = (int)strlen(sample);
+
+    if (argc > 1) {
+        FILE *file = fopen(argv[1], "rb");
+        if (file == NULL) {
+            printf("Cannot open %s\n", argv[1]);
+            return 1;
+        }
+        fseek(file, 0, SEEK_END);
+        input_len = (int)ftell(file);
+        fseek(file, 0, SEEK_SET);
+        input = malloc(input_len + 1);
+        if ((int)fread(input, 1, input_len, file) != input_len) input_len = 0;
+        fclose(file);
+    }
+
+    int capacity = LZ4_COMPRESS_BOUND(input_len);
+    uint8_t *compressed = malloc(capacity);
+    uint8_t *decompressed = malloc(input_len + 1);
+    uint32_t *table = malloc(LZ4_TABLE_SIZE * sizeof(uint32_t));
+
+    int compressed_len = lz4_compress_block(input, input_len, compressed, capacity, table);
+    int decompressed_len = lz4_decompress_block(compressed, compressed_len, decompressed, input_len);
+
+    uint32_t input_crc = lz4_crc32(0, input, input_len);
+    uint32_t output_crc = lz4_crc32(0, compressed, compressed_len);
+
+    printf("%d -> %d bytes (%.2f%%)\n", input_len, compressed_len, input_len ? 100.0 * compressed_len / input_len : 0.0);
+    printf("CRC-32: input %08x, output %08x\n", input_crc, output_crc);
+    if (decompressed_len != input_len || lz4_crc32(0, decompressed, decompressed_len) != input_crc) {
+        printf("Round trip failed\n");
+        return 1;
+    }
+    printf("Round trip OK\n");
+
+    free(compressed);
+    free(decompressed);
+    free(table);
+    if (input != (uint8_t *)sample) free(input);
+    return 0;
+}
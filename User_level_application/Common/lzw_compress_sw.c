@@ -0,0 +1,191 @@
+#include "lzw_compress_sw.h"
+#include "lzw_probes.h"
+#include <string.h>
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Dictionary
+ */
+// -------------------------------------------------------------------------------------
+
+/* Dictionary of lzw_compress_sw, the callers of lzw_compress_sw_r bring their own */
+static LzwSwDictionary default_dictionary;
+
+#ifdef LZW_STATS
+#define STATS(statement) statement
+
+static void count_probes(uint64_t histogram[LZW_STATS_PROBE_BINS], uint64_t *total, uint32_t probes) {
+    histogram[(probes < LZW_STATS_PROBE_BINS) ? probes - 1 : LZW_STATS_PROBE_BINS - 1]++;
+    *total += probes;
+}
+
+static void count_width(LzwSwStats *stats, uint32_t input_offset, uint8_t bit_count) {
+    if (stats->timeline_count < LZW_STATS_TIMELINE) {
+        stats->timeline[stats->timeline_count].input_offset = input_offset;
+        stats->timeline[stats->timeline_count].bit_count = bit_count;
+        stats->timeline_count++;
+    } else {
+        stats->timeline_dropped++;
+    }
+}
+#else
+#define STATS(statement)
+#endif
+
+static void init_dictionary(LzwSwDictionary *dictionary){
+    memset(dictionary->used, 0, sizeof(dictionary->used));
+    for (uint16_t i = 0; i < 256; i++){
+        dictionary->entries[i].code = i;
+        dictionary->entries[i].prefix_code = INVALID_CODE;
+        dictionary->entries[i].ext_byte = i;
+        dictionary->used[i] = true;
+    }
+}
+
+static void Dictionary_reset(LzwSwDictionary *dictionary, uint16_t *dictionary_size, uint8_t *bit_count) {
+    (*dictionary_size) = 256;
+    (*bit_count) = 8;
+    init_dictionary(dictionary);
+    STATS(dictionary->stats.resets++);
+}
+
+#if LZW_HASH_FUNCTION == LZW_HASH_SHIFT_XOR
+static uint32_t hash1(uint16_t prefix, uint8_t ext) {
+    return ((prefix << 8) ^ ext) & (MAX_DICTIONARY_SIZE - 1);
+}
+
+static uint32_t hash2(uint16_t prefix, uint8_t ext) {
+    return (((prefix << 5) ^ (ext * 7)) & (MAX_DICTIONARY_SIZE - 1)) | 1;
+}
+#else
+/* Same bits as hash_mix of the HLS core: hash1 is the top 12 bits, hash2 the next 12 made odd */
+static uint32_t hash_mix(uint16_t prefix, uint8_t ext) {
+    uint32_t key = ((uint32_t)ext << 12) | prefix;
+#if LZW_HASH_FUNCTION == LZW_HASH_CRC
+    for (int i = 0; i < 20; i++) key = (key >> 1) ^ (0xEDB88320u & (0u - (key & 1)));
+    return key;
+#else
+    return key * 2654435761u;
+#endif
+}
+
+static uint32_t hash1(uint16_t prefix, uint8_t ext) {
+    return hash_mix(prefix, ext) >> 20;
+}
+
+static uint32_t hash2(uint16_t prefix, uint8_t ext) {
+    return ((hash_mix(prefix, ext) >> 8) & (MAX_DICTIONARY_SIZE - 1)) | 1;
+}
+#endif
+
+static uint16_t Dictionary_find(LzwSwDictionary *dictionary, uint16_t prefix, uint8_t ext) {
+    uint32_t h1 = hash1(prefix, ext);
+    uint32_t h2 = hash2(prefix, ext);
+    for (uint32_t i = 0; i < MAX_DICTIONARY_SIZE; i++) {
+        uint32_t idx = (h1 + i * h2) & (MAX_DICTIONARY_SIZE - 1);
+        if (!dictionary->used[idx]) {
+            STATS(count_probes(dictionary->stats.find_histogram, &dictionary->stats.find_probes, i + 1));
+            STATS(dictionary->stats.misses++);
+            return INVALID_CODE;
+        }
+        if (dictionary->entries[idx].prefix_code == prefix && dictionary->entries[idx].ext_byte == ext) {
+            STATS(count_probes(dictionary->stats.find_histogram, &dictionary->stats.find_probes, i + 1));
+            STATS(dictionary->stats.hits++);
+            return dictionary->entries[idx].code;
+        }
+    }
+    STATS(count_probes(dictionary->stats.find_histogram, &dictionary->stats.find_probes, MAX_DICTIONARY_SIZE));
+    STATS(dictionary->stats.misses++);
+    return INVALID_CODE;
+}
+
+static void Dictionary_add(LzwSwDictionary *dictionary, uint16_t prefix, uint8_t ext, uint16_t *dictionary_size, uint8_t *bit_count) {
+    if (*dictionary_size >= MAX_DICTIONARY_SIZE) Dictionary_reset(dictionary, dictionary_size, bit_count);
+    if (*dictionary_size >= (1u << *bit_count)) (*bit_count)++;
+
+    uint32_t h1 = hash1(prefix, ext);
+    uint32_t h2 = hash2(prefix, ext);
+    for (uint32_t i = 0; i < MAX_DICTIONARY_SIZE; i++) {
+        uint32_t idx = (h1 + i * h2) & (MAX_DICTIONARY_SIZE - 1);
+        if (!dictionary->used[idx]) {
+            dictionary->entries[idx].prefix_code = prefix;
+            dictionary->entries[idx].ext_byte = ext;
+            dictionary->entries[idx].code = *dictionary_size;
+            dictionary->used[idx] = true;
+            (*dictionary_size)++;
+            STATS(count_probes(dictionary->stats.add_histogram, &dictionary->stats.add_probes, i + 1));
+            return;
+        }
+    }
+}
+
+static void write_output(uint16_t code, uint8_t *output, uint8_t bit_count, uint32_t *out_index){
+    uint32_t idx = *out_index;
+    uint32_t byte_index = idx / 8;
+    uint32_t bit_offset = idx % 8;
+
+    uint32_t bits_left = bit_count;
+    while (bits_left > 0) {
+        uint8_t bits_in_this_byte = 8 - bit_offset;
+        if (bits_in_this_byte > bits_left) bits_in_this_byte = bits_left;
+        uint8_t mask = (code >> (bits_left - bits_in_this_byte)) & ((1U << bits_in_this_byte) - 1);
+        output[byte_index] |= mask << (8 - bit_offset - bits_in_this_byte);
+        bits_left -= bits_in_this_byte;
+        bit_offset = 0;
+        byte_index++;
+    }
+    *out_index += bit_count;
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// -------------------------------------------------------------------------------------
+
+void lzw_compress_sw(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size){
+    lzw_compress_sw_r(&default_dictionary, input, output, input_size, compression_size);
+}
+
+#ifdef LZW_STATS
+const LzwSwStats *lzw_compress_sw_stats(void) {
+    return &default_dictionary.stats;
+}
+#endif
+
+void lzw_compress_sw_r(LzwSwDictionary *dictionary, uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size){
+    uint16_t dictionary_size = 256;
+    uint8_t bit_count = 8;
+    uint32_t out_index = 0;
+
+    memset(output, 0, input_size * 2);
+
+    init_dictionary(dictionary);
+    LZW_PROBE3(job_submit, (uintptr_t)dictionary, LZW_PROBE_COMPRESS, input_size);
+    STATS(memset(&dictionary->stats, 0, sizeof(dictionary->stats)));
+    STATS(dictionary->stats.input_bytes = input_size);
+    STATS(count_width(&dictionary->stats, 0, bit_count));
+
+    uint16_t prefix = input[0];
+    for (int i = 1; i < input_size; i++) {
+        uint8_t ext = input[i];
+        uint16_t code = Dictionary_find(dictionary, prefix, ext);
+        if (code != INVALID_CODE) {
+            prefix = code;
+        } else {
+            write_output(prefix, output, bit_count, &out_index);
+            STATS(dictionary->stats.codes_per_width[bit_count]++);
+            STATS(uint8_t previous_bit_count = bit_count);
+            if (dictionary_size >= MAX_DICTIONARY_SIZE) LZW_PROBE2(dictionary_reset, (uintptr_t)dictionary, i);
+            Dictionary_add(dictionary, prefix, ext, &dictionary_size, &bit_count);
+            STATS(if (bit_count != previous_bit_count) count_width(&dictionary->stats, i, bit_count));
+            prefix = ext;
+        }
+    }
+    write_output(prefix, output, bit_count, &out_index);
+    STATS(dictionary->stats.codes_per_width[bit_count]++);
+    STATS(dictionary->stats.codes = dictionary->stats.misses + 1);
+
+    *compression_size = (out_index + 7) / 8;
+    LZW_PROBE4(job_complete, (uintptr_t)dictionary, LZW_PROBE_COMPRESS, input_size, *compression_size);
+}
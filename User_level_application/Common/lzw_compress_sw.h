@@ -0,0 +1,104 @@
+#ifndef LZW_COMPRESS_SW_H
+#define LZW_COMPRESS_SW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Software LZW compressor with the semantics of the lzw_compress IP core (same code allocation, width
+ * growth, reset when the dictionary is full and MSB-first packing), so both outputs can be compared
+ * byte for byte. Plain C with no BSP headers: the same file builds in the Vitis applications and in
+ * the Linux benchmark (Benchmark_Src_Codes).
+ */
+#define MAX_DICTIONARY_SIZE 4096
+#define INVALID_CODE 0xFFFF
+
+/* Dictionary hash, selected at build time with LZW_HASH_FUNCTION as in the HLS core (see Benchmark_Src_Codes/hash_eval.c) */
+#define LZW_HASH_SHIFT_XOR 0        // hash1/hash2 from shifts and XORs of prefix and extension
+#define LZW_HASH_MULTIPLICATIVE 1   // Top bits of key * 2654435761
+#define LZW_HASH_CRC 2              // Top bits of the CRC-32 of the 20-bit key
+#ifndef LZW_HASH_FUNCTION
+#define LZW_HASH_FUNCTION LZW_HASH_MULTIPLICATIVE
+#endif
+
+typedef struct {
+    uint16_t prefix_code;
+    uint8_t ext_byte;
+    uint16_t code;
+} DictionaryEntry;
+
+#ifdef LZW_STATS
+/*
+ * Table behaviour of one compression, collected only in builds with LZW_STATS (the counters cost 5 to
+ * 15 % of throughput). Resets per MB = resets / (input_bytes / 2^20).
+ */
+#define LZW_STATS_PROBE_BINS 16     // Slots visited 1 to 15, the last bin counts 16 and more
+#define LZW_STATS_TIMELINE 256      // Code-width changes kept, later ones are only counted
+
+typedef struct {
+    uint32_t input_offset;          // Input byte at which the width changed
+    uint8_t bit_count;              // Code width from there on
+} LzwWidthChange;
+
+typedef struct {
+    uint64_t input_bytes;
+    uint64_t codes;                                 // Codes written
+    uint64_t hits;                                  // Lookups that found the string
+    uint64_t misses;                                // Lookups that did not (one code written each)
+    uint64_t find_probes;                           // Slots visited by all lookups
+    uint64_t add_probes;                            // Slots visited by all inserts
+    uint64_t find_histogram[LZW_STATS_PROBE_BINS];  // Lookups by slots visited
+    uint64_t add_histogram[LZW_STATS_PROBE_BINS];   // Inserts by slots visited
+    uint64_t resets;                                // Dictionary resets (dictionary full)
+    uint64_t codes_per_width[13];                   // Codes written at each width, indexed by bits
+    uint32_t timeline_count;
+    uint32_t timeline_dropped;
+    LzwWidthChange timeline[LZW_STATS_TIMELINE];
+} LzwSwStats;
+#endif
+
+/* Open-addressing table (double hashing) of one compression */
+typedef struct {
+    DictionaryEntry entries[MAX_DICTIONARY_SIZE];
+    bool used[MAX_DICTIONARY_SIZE];
+#ifdef LZW_STATS
+    LzwSwStats stats;               // Statistics of the last compression with this dictionary
+#endif
+} LzwSwDictionary;
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// ------------------------------------------------------------------------------------
+
+/**
+ * @brief Compresses input into output.
+ *
+ * @param input             Input buffer.
+ * @param output            Output buffer, at least 2 * input_size bytes (cleared here).
+ * @param input_size        Input size in bytes.
+ * @param compression_size  Compressed size in bytes.
+ */
+void lzw_compress_sw(uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size);
+
+/**
+ * @brief Re-entrant form of lzw_compress_sw: the dictionary is the caller's, so several compressions
+ *        can run at the same time (one dictionary each), e.g. on several threads.
+ *
+ * @param dictionary        Dictionary used by this compression.
+ * @param input             Input buffer.
+ * @param output            Output buffer, at least 2 * input_size bytes (cleared here).
+ * @param input_size        Input size in bytes.
+ * @param compression_size  Compressed size in bytes.
+ */
+void lzw_compress_sw_r(LzwSwDictionary *dictionary, uint8_t *input, uint8_t *output, int input_size, uint32_t *compression_size);
+
+#ifdef LZW_STATS
+/**
+ * @brief Statistics of the last lzw_compress_sw call (lzw_compress_sw_r callers read dictionary->stats).
+ */
+const LzwSwStats *lzw_compress_sw_stats(void);
+#endif
+
+#endif
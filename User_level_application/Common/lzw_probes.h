@@ -0,0 +1,41 @@
+#ifndef LZW_PROBES_H
+#define LZW_PROBES_H
+
+#include <stdint.h>
+
+/*
+ * Static tracepoints (USDT, provider "lzw") of the hosted builds. With <sys/sdt.h> (systemtap-sdt-dev)
+ * each probe is a single nop plus an ELF note until a tracer attaches, so they stay in production
+ * binaries; e.g. the latency of every compression of a running process:
+ *   bpftrace -p PID -e 'usdt:BINARY:lzw:job_submit { @t[arg0] = nsecs; }
+ *                      usdt:BINARY:lzw:job_complete /@t[arg0]/ { @us = hist((nsecs - @t[arg0]) / 1000); delete(@t[arg0]); }'
+ * Board builds (no LZW_HOSTED), hosts without the header and LZW_NO_PROBES builds compile them to nothing.
+ *
+ *   job_submit(job, op, input_size)                    compression or decompression starts
+ *   job_complete(job, op, input_size, output_size)     and ends
+ *   dictionary_reset(job, input_offset)                dictionary full, cleared
+ *   chunk_dispatch(chunk, core, length)                orchestrator started a chunk on a core
+ *   io_complete(chunk, core, compressed_size)          output of a chunk collected and visible to the host
+ * job is the address of the dictionary or of the input, so concurrent jobs can be told apart.
+ */
+#define LZW_PROBE_COMPRESS 0
+#define LZW_PROBE_DECOMPRESS 1
+
+#if defined(LZW_HOSTED) && !defined(LZW_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define LZW_PROBES_ENABLED 1
+#endif
+#endif
+
+#ifdef LZW_PROBES_ENABLED
+#define LZW_PROBE2(name, a, b) DTRACE_PROBE2(lzw, name, a, b)
+#define LZW_PROBE3(name, a, b, c) DTRACE_PROBE3(lzw, name, a, b, c)
+#define LZW_PROBE4(name, a, b, c, d) DTRACE_PROBE4(lzw, name, a, b, c, d)
+#else
+#define LZW_PROBE2(name, a, b) do { (void)(a); (void)(b); } while (0)
+#define LZW_PROBE3(name, a, b, c) do { (void)(a); (void)(b); (void)(c); } while (0)
+#define LZW_PROBE4(name, a, b, c, d) do { (void)(a); (void)(b); (void)(c); (void)(d); } while (0)
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+#include "orchestrator.h"
+#include "lzw_probes.h"
+
+/* Largest pool Orchestrator_run tracks */
+#define ORCHESTRATOR_MAX_CORES 64
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// -------------------------------------------------------------------------------------
+
+void Orchestrator_split(const uint8_t *input, const uint32_t *offsets, const uint32_t *sizes, LzwChunk *chunks,
+                        uint32_t chunk_count) {
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        chunks[i].input = input + offsets[i];
+        chunks[i].length = sizes[i];
+        chunks[i].compressed_size = 0;
+        chunks[i].input_crc = 0;
+        chunks[i].output_crc = 0;
+        chunks[i].busy_seconds = 0;
+        chunks[i].core = 0;
+    }
+}
+
+uint64_t Orchestrator_run(const LzwCoreOps *ops, void *const *cores, uint32_t core_count, LzwChunk *chunks, uint32_t chunk_count,
+                          Trace *trace) {
+    int32_t running[ORCHESTRATOR_MAX_CORES];    // Chunk of each core, -1 when idle
+    uint32_t next = 0, completed = 0;
+    uint64_t total_compression_size = 0;
+
+    // Without a core no chunk would ever start.
+    if (core_count == 0) return 0;
+    if (core_count > ORCHESTRATOR_MAX_CORES) core_count = ORCHESTRATOR_MAX_CORES;
+    for (uint32_t c = 0; c < core_count; c++) running[c] = -1;
+
+    while (completed < chunk_count) {
+        for (uint32_t c = 0; c < core_count; c++) {
+            if (running[c] >= 0 && ops->is_done(cores[c])) {
+                LzwChunk *chunk = &chunks[running[c]];
+                if (trace) {
+                    uint64_t seen = Trace_now();
+                    Trace_record(trace, TRACE_DONE, running[c], c, seen, seen);
+                }
+                ops->collect(cores[c], chunk);
+                if (ops->invalidate) {
+                    uint64_t begin = trace ? Trace_now() : 0;
+                    ops->invalidate(chunk->output, chunk->compressed_size);
+                    if (trace) Trace_record(trace, TRACE_INVALIDATE, running[c], c, begin, Trace_now());
+                }
+                LZW_PROBE3(io_complete, running[c], c, chunk->compressed_size);
+                total_compression_size += chunk->compressed_size;
+                completed++;
+                running[c] = -1;
+            }
+
+            if (running[c] < 0 && next < chunk_count) {
+                LzwChunk *chunk = &chunks[next];
+                chunk->core = c;
+                if (ops->flush) {
+                    uint64_t begin = trace ? Trace_now() : 0;
+                    ops->flush(chunk->input, chunk->length);
+                    ops->flush(chunk->output, 2 * (size_t)chunk->length);
+                    if (trace) Trace_record(trace, TRACE_FLUSH, next, c, begin, Trace_now());
+                }
+                uint64_t begin = trace ? Trace_now() : 0;
+                ops->start(cores[c], chunk);
+                if (trace) Trace_record(trace, TRACE_START, next, c, begin, Trace_now());
+                LZW_PROBE3(chunk_dispatch, next, c, chunk->length);
+                running[c] = next++;
+            }
+        }
+    }
+
+    return total_compression_size;
+}
@@ -0,0 +1,76 @@
+#ifndef ORCHESTRATOR_H
+#define ORCHESTRATOR_H
+
+#include "trace.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Host side of the Multiple IPs scheme: an input cut into chunks, handed out to a pool of lzw_compress
+ * cores, each core taking the next chunk as soon as it is done with its previous one. The cores are only
+ * reached through LzwCoreOps, so the same loop drives the XLzw_compress instances of the board and the
+ * threaded core simulator of Benchmark_Src_Codes. Every chunk is LZW: those cores have no LZ4 engine, which
+ * is only selectable per job on the lzw_compress_ring top (LZW_JOB_FLAG_LZ4).
+ */
+
+/* One chunk of the input and what its core returned */
+typedef struct {
+    const uint8_t *input;       // Start of the chunk
+    uint32_t length;            // Chunk size in bytes
+    uint8_t *output;            // Output buffer of the chunk, at least 2 * length bytes
+    uint32_t compressed_size;   // Filled in when the chunk is done
+    uint32_t input_crc;         // CRC-32 reported by the core, 0 if it has none
+    uint32_t output_crc;
+    double busy_seconds;        // Time the core spent on the chunk, 0 if the core does not report it
+    uint32_t core;              // Core that compressed the chunk
+} LzwChunk;
+
+typedef struct {
+    /** @brief Programs the core with a chunk and starts it. */
+    void (*start)(void *core, const LzwChunk *chunk);
+    /** @brief Returns non-zero once the core is done with its chunk. */
+    int (*is_done)(void *core);
+    /** @brief Reads the results of a done core into its chunk (compressed size, CRCs, busy time). */
+    void (*collect)(void *core, LzwChunk *chunk);
+    /** @brief Writes a buffer back to memory before a core reads it, NULL when there is no cache to maintain. */
+    void (*flush)(const void *buffer, size_t length);
+    /** @brief Drops a buffer from the cache after a core wrote it, NULL when there is no cache to maintain. */
+    void (*invalidate)(const void *buffer, size_t length);
+} LzwCoreOps;
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// ------------------------------------------------------------------------------------
+
+/**
+ * @brief Sets up the chunks of a partition of input (see Partition_split).
+ *        The caller sets the output buffer of every chunk.
+ *
+ * @param input         Input buffer.
+ * @param offsets       Start of each chunk in input, chunk_count entries.
+ * @param sizes         Size of each chunk, chunk_count entries.
+ * @param chunks        Chunks, chunk_count entries.
+ * @param chunk_count   Number of chunks.
+ */
+void Orchestrator_split(const uint8_t *input, const uint32_t *offsets, const uint32_t *sizes, LzwChunk *chunks,
+                        uint32_t chunk_count);
+
+/**
+ * @brief Compresses every chunk on the cores and returns once all of them are done.
+ *        Chunks are started in order, each on the first idle core.
+ *
+ * @param ops           Core operations.
+ * @param cores         Core handles passed to ops, core_count entries.
+ * @param core_count    Number of cores.
+ * @param chunks        Chunks, chunk_count entries.
+ * @param chunk_count   Number of chunks.
+ * @param trace         Receives the flush, start, done and invalidate phases of every chunk, NULL for none.
+ *
+ * @return Total compressed size in bytes, 0 without cores (no chunk is compressed).
+ */
+uint64_t Orchestrator_run(const LzwCoreOps *ops, void *const *cores, uint32_t core_count, LzwChunk *chunks, uint32_t chunk_count,
+                          Trace *trace);
+
+#endif
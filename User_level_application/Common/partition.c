@@ -0,0 +1,150 @@
+#include "partition.h"
+#include <stddef.h>
+
+#define PARTITION_MAX_WINDOWS 256       // Cost windows over the whole input
+#define PARTITION_MIN_WINDOW 4096       // Smallest window in bytes
+#define PARTITION_SAMPLE_BYTES 512      // Bytes scored at the start of each window
+#define PARTITION_SEEN_BITS 4096        // Byte-pair filter of the sampler
+#define PARTITION_DELIMITER_SEARCH 512  // How far past a boundary a delimiter is looked for
+
+/*
+ * Cost of a byte, in half cycles of the C-simulation cycle model of the HASH Version core: about 2.5
+ * cycles for every input byte and 2 more for every code emitted (output write, dictionary insert, probes).
+ */
+#define PARTITION_BYTE_COST 5
+#define PARTITION_CODE_COST 4
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                   Helper functions
+ */
+// -------------------------------------------------------------------------------------
+
+/**
+ * @brief Scores a window: the share of byte pairs of its sample not seen earlier in the sample stands for
+ *        the share of bytes that end a code, as a pair the dictionary does not know yet ends the current one.
+ *
+ * @return Predicted cost of the window.
+ */
+static uint32_t window_cost(const uint8_t *window, uint32_t length) {
+    uint32_t seen[PARTITION_SEEN_BITS / 32] = {0};
+    uint32_t sample = length < PARTITION_SAMPLE_BYTES ? length : PARTITION_SAMPLE_BYTES;
+    uint32_t novel = 0;
+
+    if (sample < 2) return length * PARTITION_BYTE_COST;
+
+    for (uint32_t i = 1; i < sample; i++) {
+        uint32_t pair = ((uint32_t)window[i - 1] << 8) | window[i];
+        uint32_t bit = (pair * 2654435761u) >> 20;
+        if ((seen[bit >> 5] & (1u << (bit & 31))) == 0) {
+            seen[bit >> 5] |= 1u << (bit & 31);
+            novel++;
+        }
+    }
+
+    return (uint32_t)(((uint64_t)length * (PARTITION_BYTE_COST * (sample - 1) + PARTITION_CODE_COST * novel)) /
+                      (sample - 1));
+}
+
+/* Moves a boundary to the next delimiter, if there is one within the search distance */
+static uint32_t snap_delimiter(const uint8_t *input, uint32_t length, uint32_t boundary, uint8_t delimiter) {
+    uint32_t end = (length - boundary > PARTITION_DELIMITER_SEARCH) ? boundary + PARTITION_DELIMITER_SEARCH : length;
+    for (uint32_t i = boundary; i < end; i++) {
+        if (input[i] == delimiter) return i + 1;
+    }
+    return boundary;
+}
+
+static uint32_t align_up(const uint8_t *input, uint32_t boundary, uint32_t alignment) {
+    uintptr_t address = (uintptr_t)(input + boundary);
+    return boundary + (uint32_t)((alignment - (address & (alignment - 1))) & (alignment - 1));
+}
+
+static uint32_t align_down(const uint8_t *input, uint32_t boundary, uint32_t alignment) {
+    uintptr_t address = (uintptr_t)(input + boundary);
+    uint32_t excess = (uint32_t)(address & (alignment - 1));
+    return (boundary >= excess) ? boundary - excess : boundary;
+}
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// -------------------------------------------------------------------------------------
+
+int Partition_split(const uint8_t *input, uint32_t length, uint32_t chunk_count, const PartitionOptions *options,
+                    uint32_t *offsets, uint32_t *sizes) {
+    if (chunk_count == 0) return (length == 0) ? 0 : -1;
+
+    if (options == NULL) {
+        uint32_t part_size = length / chunk_count;
+        uint32_t remainder = length % chunk_count;
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < chunk_count; i++) {
+            offsets[i] = offset;
+            sizes[i] = part_size + (i < remainder ? 1 : 0);
+            offset += sizes[i];
+        }
+        return 0;
+    }
+
+    uint32_t alignment = options->alignment ? options->alignment : 1;
+    uint32_t max_length = options->max_length;
+    if (max_length && (uint64_t)max_length * chunk_count < length) return -1;
+
+    // Cost of every window, the byte count itself when the split does not balance time.
+    uint32_t costs[PARTITION_MAX_WINDOWS];
+    uint32_t window_size = (length + PARTITION_MAX_WINDOWS - 1) / PARTITION_MAX_WINDOWS;
+    if (window_size < PARTITION_MIN_WINDOW) window_size = PARTITION_MIN_WINDOW;
+    uint32_t windows = (length + window_size - 1) / window_size;
+    uint64_t total_cost = 0;
+
+    for (uint32_t w = 0; w < windows; w++) {
+        uint32_t start = w * window_size;
+        uint32_t window_length = (length - start < window_size) ? length - start : window_size;
+        costs[w] = options->balance ? window_cost(input + start, window_length) : window_length;
+        total_cost += costs[w];
+    }
+
+    uint32_t previous = 0, w = 0;
+    uint64_t cost_before = 0;     // Cost of the windows before window w
+    offsets[0] = 0;
+
+    for (uint32_t k = 1; k < chunk_count; k++) {
+        uint64_t target = total_cost * k / chunk_count;
+        while (w < windows && cost_before + costs[w] <= target) cost_before += costs[w++];
+
+        // Inside its window, the boundary sits where the cost reaches the target, the window taken as uniform.
+        uint32_t boundary = length;
+        if (w < windows) {
+            uint32_t start = w * window_size;
+            uint32_t window_length = (length - start < window_size) ? length - start : window_size;
+            boundary = start + (uint32_t)((target - cost_before) * window_length / costs[w]);
+        }
+
+        if (options->delimiter >= 0) boundary = snap_delimiter(input, length, boundary, (uint8_t)options->delimiter);
+        if (boundary < length) boundary = align_up(input, boundary, alignment);
+
+        // Keep the chunks in order and within max_length, the chunks left after this one included.
+        uint32_t low = previous, high = length;
+        if (max_length) {
+            uint64_t rest = (uint64_t)max_length * (chunk_count - k);
+            if (length > rest && length - rest > low) low = (uint32_t)(length - rest);
+            if (previous + max_length < high) high = previous + max_length;
+        }
+        if (boundary < low) {
+            boundary = align_up(input, low, alignment);
+            if (boundary > high) boundary = low;
+        } else if (boundary > high) {
+            boundary = align_down(input, high, alignment);
+            if (boundary < low) boundary = high;
+        }
+
+        sizes[k - 1] = boundary - previous;
+        offsets[k] = boundary;
+        previous = boundary;
+    }
+    sizes[chunk_count - 1] = length - previous;
+
+    return (max_length && sizes[chunk_count - 1] > max_length) ? -1 : 0;
+}
@@ -0,0 +1,44 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <stdint.h>
+
+/*
+ * Splits an input between the compressors of the parallel applications. Instead of equal byte counts,
+ * the split can balance the predicted compression time of the chunks: the input is cut in windows, a
+ * sample of each window is scored for how many LZW codes it will emit, and the chunk boundaries are
+ * placed at equal shares of the summed cost. Boundaries are then snapped to the byte after a delimiter
+ * (line or record ends) and to an address alignment (cache line or AXI word), so that every chunk starts
+ * on a line the cache maintenance can flush on its own and on the first byte of a burst.
+ */
+
+typedef struct {
+    uint32_t alignment;     // Chunk starts are aligned to this many bytes in memory (power of two), 1 for none
+    uint32_t max_length;    // Largest chunk in bytes, the output buffers are sized for it, 0 for no limit
+    int32_t delimiter;      // Chunks start after this byte when one is close to the boundary, -1 for none
+    int balance;            // Non-zero: balance the predicted compression time, zero: balance byte counts
+} PartitionOptions;
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// ------------------------------------------------------------------------------------
+
+/**
+ * @brief Cuts input in chunk_count consecutive chunks that cover it.
+ *        With options NULL, the chunks are equal, the remainder spread over the first ones.
+ *
+ * @param input         Input buffer.
+ * @param length        Input size in bytes.
+ * @param chunk_count   Number of chunks.
+ * @param options       Partition options, NULL for an equal split.
+ * @param offsets       Start of each chunk in input, chunk_count entries.
+ * @param sizes         Size of each chunk, chunk_count entries.
+ *
+ * @return 0 on success, -1 if the input does not fit in chunk_count chunks of max_length bytes.
+ */
+int Partition_split(const uint8_t *input, uint32_t length, uint32_t chunk_count, const PartitionOptions *options,
+                    uint32_t *offsets, uint32_t *sizes);
+
+#endif
@@ -0,0 +1,120 @@
+#include "trace.h"
+#include <stdio.h>
+
+#if defined(LZW_HOSTED)
+#include <time.h>
+#elif !defined(__aarch64__)
+#include "xparameters.h"
+#endif
+
+// -------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// -------------------------------------------------------------------------------------
+
+#if defined(LZW_HOSTED)
+
+uint64_t Trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+uint64_t Trace_frequency(void) {
+    return 1000000000u;
+}
+
+#elif defined(__aarch64__)
+
+/* KV260: generic timer of the Cortex-A53 */
+uint64_t Trace_now(void) {
+    uint64_t val;
+    asm volatile("mrs %0, cntvct_el0" : "=r" (val));
+    return val;
+}
+
+uint64_t Trace_frequency(void) {
+    uint64_t val;
+    asm volatile("mrs %0, cntfrq_el0" : "=r" (val));
+    return val;
+}
+
+#else
+
+/* ZedBoard: 64-bit global timer of the Cortex-A9, at half the CPU clock */
+uint64_t Trace_now(void) {
+    volatile uint32_t *timer_lo = (volatile uint32_t *)(XPAR_PS7_GLOBALTIMER_0_BASEADDR);
+    volatile uint32_t *timer_hi = (volatile uint32_t *)(XPAR_PS7_GLOBALTIMER_0_BASEADDR + 4);
+    uint32_t hi1, lo, hi2;
+    do {
+        hi1 = *timer_hi;
+        lo = *timer_lo;
+        hi2 = *timer_hi;
+    } while (hi1 != hi2);
+    return ((uint64_t)hi1 << 32) | lo;
+}
+
+uint64_t Trace_frequency(void) {
+    return XPAR_CPU_CORE_CLOCK_FREQ_HZ / 2;
+}
+
+#endif
+
+void Trace_init(Trace *trace) {
+    trace->count = 0;
+    trace->dropped = 0;
+    trace->origin = Trace_now();
+}
+
+void Trace_record(Trace *trace, TracePhase phase, uint32_t job, uint32_t core, uint64_t begin, uint64_t end) {
+    if (trace == NULL) return;
+    if (trace->count >= TRACE_MAX_EVENTS) {
+        trace->dropped++;
+        return;
+    }
+
+    TraceEvent *event = &trace->events[trace->count++];
+    event->begin = begin - trace->origin;
+    event->end = end - trace->origin;
+    event->job = job;
+    event->core = (uint16_t)core;
+    event->phase = (uint16_t)phase;
+}
+
+const char *Trace_phase_name(TracePhase phase) {
+    static const char *const names[TRACE_PHASE_COUNT] = {"read", "flush", "start", "done", "invalidate", "write"};
+    return (phase < TRACE_PHASE_COUNT) ? names[phase] : "unknown";
+}
+
+size_t Trace_format_csv(const Trace *trace, char *buffer, size_t size) {
+    double us_per_tick = 1e6 / (double)Trace_frequency();
+    size_t length = 0;
+    char line[96];
+
+    for (int i = -1; i < (int)trace->count; i++) {
+        int n;
+        if (i < 0) {
+            n = snprintf(line, sizeof(line), "phase,job,core,begin_us,end_us\n");
+        } else {
+            const TraceEvent *event = &trace->events[i];
+            n = snprintf(line, sizeof(line), "%s,%ld,%d,%.3f,%.3f\n", Trace_phase_name((TracePhase)event->phase),
+                         event->job == TRACE_NO_JOB ? -1L : (long)event->job,
+                         event->core == TRACE_NO_CORE ? -1 : (int)event->core, event->begin * us_per_tick,
+                         event->end * us_per_tick);
+        }
+        if (n < 0 || length + (size_t)n >= size) break;
+        for (int c = 0; c < n; c++) buffer[length++] = line[c];
+    }
+
+    if (size > 0) buffer[length] = '\0';
+    return length;
+}
+
+void Trace_file_header(const Trace *trace, TraceFileHeader *header) {
+    header->magic = TRACE_MAGIC;
+    header->version = TRACE_VERSION;
+    header->count = trace->count;
+    header->dropped = trace->dropped;
+    header->frequency_hz = Trace_frequency();
+}
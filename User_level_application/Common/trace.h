@@ -0,0 +1,107 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Timeline of the host side of a run: each phase of each job (SD read, cache flush, core start, done seen
+ * by the host, cache invalidate, SD write) is timestamped into a fixed buffer, with no I/O until the run
+ * is over. The timestamps come from the ZedBoard global timer, the cntvct_el0 counter of the KV260, or
+ * CLOCK_MONOTONIC when built with LZW_HOSTED. trace_gantt.py renders a dump as a Gantt chart.
+ */
+
+#define TRACE_MAX_EVENTS 1024
+#define TRACE_NO_JOB 0xFFFFFFFFu    // Phases that are not tied to one chunk (reading the whole input)
+#define TRACE_NO_CORE 0xFFFFu       // Phases run by the host alone
+
+/* Layout of the binary dump: the header, then count TraceEvent */
+#define TRACE_MAGIC 0x5457524Cu     // "LZWT"
+#define TRACE_VERSION 1
+
+typedef enum {
+    TRACE_READ,         // Input read from storage
+    TRACE_FLUSH,        // Input and output of a chunk flushed from the cache
+    TRACE_START,        // Core programmed and started
+    TRACE_DONE,         // Done seen by the host (begin = end)
+    TRACE_INVALIDATE,   // Output of a chunk dropped from the cache
+    TRACE_WRITE,        // Output written to storage
+    TRACE_PHASE_COUNT
+} TracePhase;
+
+typedef struct {
+    uint64_t begin;     // Counter ticks since Trace_init
+    uint64_t end;
+    uint32_t job;       // Chunk index or TRACE_NO_JOB
+    uint16_t core;      // Core index or TRACE_NO_CORE
+    uint16_t phase;     // TracePhase
+} TraceEvent;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t dropped;
+    uint64_t frequency_hz;
+} TraceFileHeader;
+
+typedef struct {
+    uint64_t origin;            // Counter value at Trace_init
+    uint32_t count;
+    uint32_t dropped;           // Events recorded while the buffer was full
+    TraceEvent events[TRACE_MAX_EVENTS];
+} Trace;
+
+// ------------------------------------------------------------------------------------
+/*
+ *                                      Functions
+ */
+// ------------------------------------------------------------------------------------
+
+/**
+ * @brief Empties the trace and sets its time origin to now.
+ */
+void Trace_init(Trace *trace);
+
+/**
+ * @brief Current value of the free-running counter of the platform.
+ */
+uint64_t Trace_now(void);
+
+/**
+ * @brief Frequency of the Trace_now counter in Hz.
+ */
+uint64_t Trace_frequency(void);
+
+/**
+ * @brief Records one phase. Begin and end are Trace_now values; events past TRACE_MAX_EVENTS are counted
+ *        as dropped.
+ *
+ * @param trace     Trace, NULL to record nothing.
+ * @param phase     Phase.
+ * @param job       Chunk index or TRACE_NO_JOB.
+ * @param core      Core index or TRACE_NO_CORE.
+ * @param begin     Counter value when the phase began.
+ * @param end       Counter value when it ended.
+ */
+void Trace_record(Trace *trace, TracePhase phase, uint32_t job, uint32_t core, uint64_t begin, uint64_t end);
+
+/**
+ * @brief Name of a phase, as written in the CSV dump.
+ */
+const char *Trace_phase_name(TracePhase phase);
+
+/**
+ * @brief Writes the trace as CSV ("phase,job,core,begin_us,end_us", -1 for no job or core) into buffer.
+ *        Lines that do not fit are left out.
+ *
+ * @return Bytes written, without the terminating null.
+ */
+size_t Trace_format_csv(const Trace *trace, char *buffer, size_t size);
+
+/**
+ * @brief Fills the header of a binary dump of the trace, to be written before its events.
+ */
+void Trace_file_header(const Trace *trace, TraceFileHeader *header);
+
+#endif
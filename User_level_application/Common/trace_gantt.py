@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Gantt chart of a run traced with trace.h:
+    trace_gantt.py trace.csv [-o chart.png]
+
+Reads the CSV dump (Trace_format_csv) or the binary one (TraceFileHeader then the TraceEvent array,
+little-endian, as written by scaling --trace-bin). One row per core plus a host row for the storage phases: the flush, start and invalidate
+phases of every chunk, and a busy bar from the end of its start to the moment the host saw it done.
+Prints the busy time of each core, the imbalance (max / mean busy) and the time the host spent in each
+phase, then draws the chart when matplotlib is available.
+"""
+import argparse
+import csv
+import struct
+import sys
+
+PHASES = ["read", "flush", "start", "done", "invalidate", "write"]
+COLORS = {"read": "tab:gray", "flush": "tab:orange", "start": "tab:red", "busy": "tab:blue",
+          "invalidate": "tab:purple", "write": "tab:green"}
+
+TRACE_MAGIC = 0x5457524C
+HEADER = struct.Struct("<IIIIQ")
+EVENT = struct.Struct("<QQIHH")
+
+
+def read_trace(path):
+    """Returns the events as (phase, job, core, begin_us, end_us), job and core -1 when there is none."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if len(data) >= HEADER.size and HEADER.unpack_from(data)[0] == TRACE_MAGIC:
+        _, version, count, dropped, frequency_hz = HEADER.unpack_from(data)
+        if dropped:
+            print(f"warning: {dropped} events were dropped", file=sys.stderr)
+        events = []
+        for i in range(count):
+            begin, end, job, core, phase = EVENT.unpack_from(data, HEADER.size + i * EVENT.size)
+            events.append((PHASES[phase] if phase < len(PHASES) else "unknown",
+                           -1 if job == 0xFFFFFFFF else job, -1 if core == 0xFFFF else core,
+                           begin * 1e6 / frequency_hz, end * 1e6 / frequency_hz))
+        return events
+
+    rows = csv.DictReader(data.decode().splitlines())
+    return [(r["phase"], int(r["job"]), int(r["core"]), float(r["begin_us"]), float(r["end_us"])) for r in rows]
+
+
+def busy_bars(events):
+    """Pairs every start with the done of the same job: (core, job, begin_us, end_us)."""
+    started = {(job, core): end for phase, job, core, begin, end in events if phase == "start"}
+    bars = []
+    for phase, job, core, begin, end in events:
+        if phase == "done" and (job, core) in started:
+            bars.append((core, job, started[(job, core)], begin))
+    return bars
+
+
+def summarize(events, bars):
+    cores = sorted({core for core, _, _, _ in bars})
+    busy = {core: sum(end - begin for c, _, begin, end in bars if c == core) for core in cores}
+    span = max((end for _, _, _, _, end in events), default=0.0)
+
+    print(f"span {span:.1f} us, {len(bars)} chunks on {len(cores)} cores")
+    for core in cores:
+        print(f"  core {core:2d}: busy {busy[core]:10.1f} us ({100.0 * busy[core] / span if span else 0:5.1f}%)")
+    if cores:
+        mean = sum(busy.values()) / len(cores)
+        print(f"  imbalance (max / mean busy): {max(busy.values()) / mean if mean else 0:.3f}")
+    for phase in PHASES:
+        total = sum(end - begin for p, _, _, begin, end in events if p == phase)
+        if phase != "done" and total:
+            print(f"  host {phase:10s} {total:10.1f} us")
+
+
+def draw(events, bars, output):
+    try:
+        import matplotlib
+        if output:
+            matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print("matplotlib not found, no chart drawn", file=sys.stderr)
+        return
+
+    cores = sorted({core for _, _, core, _, _ in events if core >= 0})
+    rows = {core: i + 1 for i, core in enumerate(cores)}
+    fig, ax = plt.subplots(figsize=(12, 1 + 0.4 * (len(cores) + 1)))
+
+    for core, job, begin, end in bars:
+        ax.barh(rows[core], end - begin, left=begin, color=COLORS["busy"], edgecolor="none")
+        ax.text(begin, rows[core], f" {job}", va="center", fontsize=7, color="white")
+    for phase, job, core, begin, end in events:
+        if phase == "done":
+            continue
+        ax.barh(rows.get(core, 0), max(end - begin, 1e-3), left=begin, color=COLORS.get(phase, "black"),
+                edgecolor="none")
+
+    ax.set_yticks([0] + [rows[c] for c in cores])
+    ax.set_yticklabels(["host"] + [f"core {c}" for c in cores])
+    ax.invert_yaxis()
+    ax.set_xlabel("time (us)")
+    handles = [plt.Rectangle((0, 0), 1, 1, color=color) for color in COLORS.values()]
+    ax.legend(handles, COLORS.keys(), loc="upper right", fontsize=8, ncol=len(COLORS))
+    fig.tight_layout()
+
+    if output:
+        fig.savefig(output, dpi=120)
+    else:
+        plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trace", help="trace.csv or binary dump")
+    parser.add_argument("-o", "--output", help="image file for the chart instead of a window")
+    args = parser.parse_args()
+
+    events = read_trace(args.trace)
+    bars = busy_bars(events)
+    summarize(events, bars)
+    draw(events, bars, args.output)
+
+
+if __name__ == "__main__":
+    main()
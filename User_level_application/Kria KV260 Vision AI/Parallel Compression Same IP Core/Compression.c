@@ -0,0 +1,122 @@
+#include "xtop_parallel_lzw.h"
+#include "partition.h"               // User_level_application/Common
+#include "lzw_descriptor.h"          // HLS_src_codes/Kria KV260 Vision AI/Parallel Compression Same IP Core
+#include "input.h"
+#include "xparameters.h"
+#include "xil_cache.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <xil_types.h>
+#include <stdbool.h>
+#include <xstatus.h>
+
+#define FILE_INPUT_SIZE 4*1024*1024
+#define PL_CLK_FREQ_HZ 100000000              // Clock of the top_parallel_lzw core (FCLK_CLK0 of the block design)
+#define CACHE_LINE_BYTES 64                    // L1/L2 line of the Cortex-A53
+/* Chunks are balanced on predicted time, not bytes: one may grow up to twice the equal share */
+#define MAX_CHUNK_SIZE (2 * (FILE_INPUT_SIZE / NUMBER_PARALLEL_FUNCTIONS))
+/* The core writes whole memory words: every output buffer starts word aligned and is rounded up to a word */
+#define OUTPUT_BUFFER_SIZE ((2 * MAX_CHUNK_SIZE + MEMORY_WORD_BYTES - 1) & ~(MEMORY_WORD_BYTES - 1))
+
+static uint8_t outputs[NUMBER_PARALLEL_FUNCTIONS][OUTPUT_BUFFER_SIZE] __attribute__((aligned(MEMORY_WORD_BYTES))) = {{0}};
+static LzwDescriptor descriptors[NUMBER_PARALLEL_FUNCTIONS] __attribute__((aligned(64)));
+
+uint32_t read_counter_frequency(void) {
+    uint32_t val;
+    asm volatile("mrs %0, cntfrq_el0" : "=r" (val));
+    return val;
+}
+
+uint64_t read_counter_value(void) {
+    uint64_t val;
+    asm volatile("mrs %0, cntvct_el0" : "=r" (val));
+    return val;
+}
+
+int main() {
+    XTop_parallel_lzw compressor;
+    uint64_t start, end;
+    int status;
+
+    int input_length = input_txt_len;
+
+    printf("\n-------------------------------------- Test 1 - %d Functions --------------------------------------\n", NUMBER_PARALLEL_FUNCTIONS);
+
+    uint32_t freq = read_counter_frequency();
+
+    // The engines run side by side and the core is done with its slowest one: balance the chunks on
+    // predicted compression time, each starting on a cache line (and so on a memory word of the core).
+    PartitionOptions partition = {CACHE_LINE_BYTES, MAX_CHUNK_SIZE, -1, 1};
+    uint32_t sizes[NUMBER_PARALLEL_FUNCTIONS];
+    uint32_t offsets[NUMBER_PARALLEL_FUNCTIONS];
+
+    if (Partition_split(input_txt, input_length, NUMBER_PARALLEL_FUNCTIONS, &partition, offsets, sizes) != 0) {
+        printf("Input of %d bytes does not fit in %d chunks\r\n", input_length, NUMBER_PARALLEL_FUNCTIONS);
+        return 1;
+    }
+
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        descriptors[i].src = (uint32_t)((UINTPTR)input_txt + offsets[i]);
+        descriptors[i].len = sizes[i];
+        descriptors[i].dst = (uint32_t)(UINTPTR)outputs[i];
+        descriptors[i].size_out = 0;
+        descriptors[i].cycles = 0;
+
+        Xil_DCacheFlushRange((UINTPTR)input_txt + offsets[i], sizes[i]);
+        Xil_DCacheFlushRange((UINTPTR)outputs[i], OUTPUT_BUFFER_SIZE);
+    }
+    Xil_DCacheFlushRange((UINTPTR)descriptors, sizeof(descriptors));
+
+    status = XTop_parallel_lzw_Initialize(&compressor, XPAR_TOP_PARALLEL_LZW_0_BASEADDR);
+    if (status != XST_SUCCESS) {
+        printf("Failed to initialize Top_parallel_lzw HW, %d\r\n", status);
+        return 1;
+    }
+
+    XTop_parallel_lzw_Set_descriptors(&compressor, (UINTPTR)descriptors);
+    XTop_parallel_lzw_Set_memory_rd(&compressor, 0);
+    XTop_parallel_lzw_Set_memory_wr(&compressor, 0);
+
+    start = read_counter_value();
+
+    XTop_parallel_lzw_Start(&compressor);
+    while (!XTop_parallel_lzw_IsDone(&compressor));
+
+    end = read_counter_value();
+
+    uint64_t elapsed_cycles = end - start;
+    double elapsed_time_sec = (double)elapsed_cycles / freq;
+
+    printf("Parallel compression time: %.6f seconds\r\n", elapsed_time_sec);
+
+    printf("\n-------------------------------------- Final Results --------------------------------------\n");
+
+    Xil_DCacheInvalidateRange((UINTPTR)descriptors, sizeof(descriptors));
+
+    uint64_t total_compression_size = 0;
+    uint64_t total_busy_cycles = 0;
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        uint32_t compression_size = descriptors[i].size_out;
+        Xil_DCacheInvalidateRange((UINTPTR)outputs[i], compression_size);
+
+        // Each engine reports the cycles it was busy compressing, without the burst phases.
+        double busy_time_sec = (double)descriptors[i].cycles / PL_CLK_FREQ_HZ;
+        printf("Engine %d: %lu -> %lu bytes, %lu busy cycles, %.2f MB/s\n", i + 1, (unsigned long)sizes[i],
+               (unsigned long)compression_size, (unsigned long)descriptors[i].cycles,
+               busy_time_sec > 0 ? sizes[i] / busy_time_sec / 1e6 : 0.0);
+
+        total_compression_size += compression_size;
+        total_busy_cycles += descriptors[i].cycles;
+    }
+
+    double elapsed_pl_cycles = elapsed_time_sec * PL_CLK_FREQ_HZ;
+    printf("Total compression size = %lu\n", (unsigned long)total_compression_size);
+    printf("Compression ratio: %.2f%%\n", 100.0 * (double)total_compression_size / input_length);
+    printf("Aggregate throughput: %.2f MB/s\n", elapsed_time_sec > 0 ? input_length / elapsed_time_sec / 1e6 : 0.0);
+    printf("Engine utilization: %.2f%%\n",
+           elapsed_pl_cycles > 0 ? 100.0 * total_busy_cycles / (elapsed_pl_cycles * NUMBER_PARALLEL_FUNCTIONS) : 0.0);
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include "xlzw_compress_ring.h"
+#include "xparameters.h"
+#include "xil_cache.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <xil_types.h>
+#include "xscutimer.h"
+#include <stdbool.h>
+#include <xstatus.h>
+#include "ff.h"
+
+#define FILE_INPUT_SIZE 4*1024*1024
+#define COUNTER_CLK_FREQ_HZ XPAR_CPU_CORE_CLOCK_FREQ_HZ/2
+#define RING_SIZE 64                    // Ring slots (power of two)
+#define RECORD_SIZE 4096                // Input split into records of this size (1-16 KB jobs)
+#define CACHE_LINE 32
+#define RING_LZ4_EVERY 0                // Every Nth record goes to the LZ4 engine (1: all of them, 0: none)
+
+/* Must match the ring structures of the HLS core */
+#define LZW_JOB_DONE    1
+#define LZW_JOB_FLAG_LZ4 0x1
+
+typedef struct {
+    uint32_t src;
+    uint32_t dst;
+    uint32_t len;
+    uint32_t flags;
+} LzwJob;
+
+typedef struct {
+    uint32_t compressed_size;
+    uint32_t status;
+    uint32_t input_crc;
+    uint32_t output_crc;
+    uint32_t reserved[3];
+    uint32_t sequence;          // Last word the core writes
+} LzwCompletion;
+
+typedef struct {
+    uint32_t tail;
+    uint32_t stop;
+} LzwRingControl;
+
+static uint8_t input[FILE_INPUT_SIZE];
+static uint8_t output[2 * FILE_INPUT_SIZE] = {0};
+static LzwJob jobs[RING_SIZE] __attribute__((aligned(CACHE_LINE)));
+static LzwCompletion completions[RING_SIZE] __attribute__((aligned(CACHE_LINE)));
+static LzwRingControl control __attribute__((aligned(CACHE_LINE)));
+
+/*
+ * Cache maintenance rules: the host only ever writes jobs and control (flush after writing) and only
+ * reads completions (invalidate before reading); it never writes a line the core writes.
+ */
+static uint32_t compression_sizes[FILE_INPUT_SIZE / RECORD_SIZE + 1];
+static uint32_t output_crcs[FILE_INPUT_SIZE / RECORD_SIZE + 1];     // CRC-32 of each compressed record, from its completion
+
+/*
+ * Picks the engine of a job: LZ4 for records that must decode fast (hot logs), LZW for the better ratio.
+ * The engine is chosen per job, so both kinds of record can share the ring.
+ */
+static uint32_t select_engine(uint32_t record) {
+    return (RING_LZ4_EVERY != 0 && record % RING_LZ4_EVERY == 0) ? LZW_JOB_FLAG_LZ4 : 0;
+}
+
+FIL fil;
+FATFS fatfs;
+static const TCHAR *Path = "0:";
+static char finput[32] = "input.txt";
+
+int ReadSD(uint8_t *input, int *input_length){
+    FRESULT Res;
+    UINT NumBytesRead;
+
+    Res = f_mount(&fatfs, Path, 0);
+    if (Res != FR_OK) {
+        printf("Mount failed\n");
+        return XST_FAILURE;
+    }
+
+    Res = f_open(&fil, finput, FA_READ);
+    if (Res != FR_OK) {
+        printf("Open failed\n");
+        return XST_FAILURE;
+    }
+
+    Res = f_read(&fil, input, sizeof(input[0]) * FILE_INPUT_SIZE, &NumBytesRead);
+    if (Res != FR_OK){
+        printf("Read failed\n");
+        printf("Res = %d\n", Res);
+        f_close(&fil);
+        return XST_FAILURE;
+    }
+
+    f_close(&fil);
+
+    printf("Read %u bytes from SD card.\n", NumBytesRead);
+    (* input_length) = NumBytesRead;
+
+    return XST_SUCCESS;
+}
+
+static inline uint64_t get_global_time() {
+    volatile uint32_t *timer_lo = (volatile uint32_t *)(XPAR_PS7_GLOBALTIMER_0_BASEADDR);
+    volatile uint32_t *timer_hi = (volatile uint32_t *)(XPAR_PS7_GLOBALTIMER_0_BASEADDR + 4);
+    uint32_t hi1, lo, hi2;
+    do {
+        hi1 = *timer_hi;
+        lo = *timer_lo;
+        hi2 = *timer_hi;
+    } while (hi1 != hi2);
+    return ((uint64_t)hi1 << 32) | lo;
+}
+
+int main() {
+    XLzw_compress_ring compressor;
+    uint64_t start, end;
+    int status;
+    int input_length = 0;
+
+    printf("\n-------------------------------------- Test 1 - Job ring --------------------------------------\n");
+
+    status = ReadSD(input, &input_length);
+    if (status != XST_SUCCESS) {
+        printf("Failed to read sd card, %d\r\n", status);
+        return status;
+    }
+
+    uint32_t record_count = (input_length + RECORD_SIZE - 1) / RECORD_SIZE;
+
+    memset(completions, 0, sizeof(completions));
+    memset(&control, 0, sizeof(control));
+    Xil_DCacheFlushRange((UINTPTR)input, input_length);
+    Xil_DCacheFlushRange((UINTPTR)output, 2 * input_length);
+    Xil_DCacheFlushRange((UINTPTR)completions, sizeof(completions));
+    Xil_DCacheFlushRange((UINTPTR)&control, sizeof(control));
+
+    status = XLzw_compress_ring_Initialize(&compressor, XPAR_LZW_COMPRESS_RING_0_BASEADDR);
+    if (status != XST_SUCCESS) {
+        printf("Failed to initialize Lzw_compress_ring HW, %d\r\n", status);
+        return 1;
+    }
+
+    XLzw_compress_ring_Set_control(&compressor, (UINTPTR)&control);
+    XLzw_compress_ring_Set_jobs(&compressor, (UINTPTR)jobs);
+    XLzw_compress_ring_Set_completions(&compressor, (UINTPTR)completions);
+    XLzw_compress_ring_Set_memory(&compressor, 0);
+    XLzw_compress_ring_Set_ring_size(&compressor, RING_SIZE);
+
+    start = get_global_time();
+
+    // The core is started once and then only sees tail updates.
+    XLzw_compress_ring_Start(&compressor);
+
+    uint32_t submitted = 0;
+    uint32_t completed = 0;
+    uint64_t total_compression_size = 0;
+
+    while (completed < record_count) {
+        if (submitted < record_count && submitted - completed < RING_SIZE) {
+            uint32_t slot = submitted & (RING_SIZE - 1);
+            uint32_t offset = submitted * RECORD_SIZE;
+            uint32_t len = (offset + RECORD_SIZE <= (uint32_t)input_length) ? RECORD_SIZE : input_length - offset;
+
+            jobs[slot].src = (uint32_t)(UINTPTR)(input + offset);
+            jobs[slot].dst = (uint32_t)(UINTPTR)(output + 2 * offset);
+            jobs[slot].len = len;
+            jobs[slot].flags = select_engine(submitted);
+            Xil_DCacheFlushRange((UINTPTR)&jobs[slot], sizeof(LzwJob));
+
+            submitted++;
+            control.tail = submitted;
+            Xil_DCacheFlushRange((UINTPTR)&control, sizeof(control));
+            continue;
+        }
+
+        uint32_t slot = completed & (RING_SIZE - 1);
+        Xil_DCacheInvalidateRange((UINTPTR)&completions[slot], sizeof(LzwCompletion));
+        if (completions[slot].sequence != completed + 1) continue;
+
+        if (completions[slot].status != LZW_JOB_DONE) {
+            printf("Job %u failed with status %u\n", completed, completions[slot].status);
+        }
+        compression_sizes[completed] = completions[slot].compressed_size;
+        output_crcs[completed] = completions[slot].output_crc;
+        total_compression_size += completions[slot].compressed_size;
+        completed++;
+    }
+
+    end = get_global_time();
+
+    control.stop = 1;
+    Xil_DCacheFlushRange((UINTPTR)&control, sizeof(control));
+    while (!XLzw_compress_ring_IsDone(&compressor));
+
+    uint64_t elapsed_cycles = end - start;
+    double elapsed_time_sec = (double)elapsed_cycles / COUNTER_CLK_FREQ_HZ;
+
+    printf("Ring compression time: %.6f seconds for %u jobs of %d bytes\r\n", elapsed_time_sec, record_count, RECORD_SIZE);
+    printf("Throughput: %.2f MB/s\n", (double)input_length / elapsed_time_sec / (1024.0 * 1024.0));
+
+    printf("\n-------------------------------------- Final Results --------------------------------------\n");
+
+    Xil_DCacheInvalidateRange((UINTPTR)output, 2 * input_length);
+
+    printf("Total compression size = %lu\n", (unsigned long)total_compression_size);
+    printf("Compression ratio: %.2f%%\n", 100.0 * (double)total_compression_size / input_length);
+    if (record_count > 0) printf("Record 0: %lu bytes, CRC-32 %08lx\n", (unsigned long)compression_sizes[0], (unsigned long)output_crcs[0]);
+
+    return 0;
+}
@@ -1,4 +1,6 @@
 #include "xtop_parallel_lzw.h"
+#include "partition.h"               // User_level_application/Common
+#include "lzw_descriptor.h"          // HLS_src_codes/ZedBoard/Parallel Compression Same IP Core
 #include "xparameters.h"
 #include "xil_cache.h"
 #include <stdint.h>
@@ -12,12 +14,17 @@
 #include <xstatus.h>
 #include "ff.h"
 
-#define NUMBERS_FUNCTIONS_PARALLEL 10
 #define FILE_INPUT_SIZE 4*1024*1024
 #define COUNTER_CLK_FREQ_HZ XPAR_CPU_CORE_CLOCK_FREQ_HZ/2
+#define CACHE_LINE_BYTES 32                    // L1/L2 line of the Cortex-A9
+/* Chunks are balanced on predicted time, not bytes: one may grow up to twice the equal share */
+#define MAX_CHUNK_SIZE (2 * (FILE_INPUT_SIZE / NUMBER_PARALLEL_FUNCTIONS))
+/* The core writes whole memory words: every output buffer starts word aligned and is rounded up to a word */
+#define OUTPUT_BUFFER_SIZE ((2 * MAX_CHUNK_SIZE + MEMORY_WORD_BYTES - 1) & ~(MEMORY_WORD_BYTES - 1))
 
-static uint8_t input[FILE_INPUT_SIZE];
-uint8_t outputs[NUMBERS_FUNCTIONS_PARALLEL][2 * (FILE_INPUT_SIZE / NUMBERS_FUNCTIONS_PARALLEL)] = {{0}};
+static uint8_t input[FILE_INPUT_SIZE] __attribute__((aligned(CACHE_LINE_BYTES)));
+uint8_t outputs[NUMBER_PARALLEL_FUNCTIONS][OUTPUT_BUFFER_SIZE] __attribute__((aligned(MEMORY_WORD_BYTES))) = {{0}};
+static LzwDescriptor descriptors[NUMBER_PARALLEL_FUNCTIONS] __attribute__((aligned(32)));
 
 FIL fil;
 FATFS fatfs;
@@ -57,7 +64,7 @@ int ReadSD(uint8_t *input, int *input_length){
     return XST_SUCCESS;
 }
 
-int WriteSD(uint8_t outputs[NUMBERS_FUNCTIONS_PARALLEL][2 * (FILE_INPUT_SIZE / NUMBERS_FUNCTIONS_PARALLEL)], uint32_t compression_sizes[NUMBERS_FUNCTIONS_PARALLEL]) {
+int WriteSD(uint8_t outputs[NUMBER_PARALLEL_FUNCTIONS][OUTPUT_BUFFER_SIZE], uint32_t compression_sizes[NUMBER_PARALLEL_FUNCTIONS]) {
     FRESULT Res;
     UINT NumBytesWritten;
     UINT TotalNumBytesWritten = 0;
@@ -76,8 +83,8 @@ int WriteSD(uint8_t outputs[NUMBERS_FUNCTIONS_PARALLEL][2 * (FILE_INPUT_SIZE / N
     
     char header[128] = {0};
     UINT header_len = 0;
-    header_len += snprintf(header + header_len, sizeof(header) - header_len, "%d", NUMBERS_FUNCTIONS_PARALLEL);
-    for (int i = 0; i < NUMBERS_FUNCTIONS_PARALLEL; i++) {
+    header_len += snprintf(header + header_len, sizeof(header) - header_len, "%d", NUMBER_PARALLEL_FUNCTIONS);
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
         header_len += snprintf(header + header_len, sizeof(header) - header_len, " %u", compression_sizes[i]);
     }
     header_len += snprintf(header + header_len, sizeof(header) - header_len, "\n");
@@ -91,7 +98,7 @@ int WriteSD(uint8_t outputs[NUMBERS_FUNCTIONS_PARALLEL][2 * (FILE_INPUT_SIZE / N
 
     TotalNumBytesWritten += NumBytesWritten;
 
-    for (int i = 0; i < NUMBERS_FUNCTIONS_PARALLEL; i++) {
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
         Res = f_write(&fil, outputs[i], compression_sizes[i], &NumBytesWritten);
         if (Res != FR_OK || NumBytesWritten != compression_sizes[i]) {
             printf("Data write failed at core %d\n", i);
@@ -125,7 +132,7 @@ int main() {
     int status;
     int input_length = 0;
 
-    printf("\n-------------------------------------- Test 1 - 10 Functions - 200MHz --------------------------------------\n");
+    printf("\n-------------------------------------- Test 1 - %d Functions - 200MHz --------------------------------------\n", NUMBER_PARALLEL_FUNCTIONS);
 
     status = ReadSD(input, &input_length);
     if (status != XST_SUCCESS) {
@@ -133,20 +140,27 @@ int main() {
         return status;
     }
 
-    int part_size = input_length / NUMBERS_FUNCTIONS_PARALLEL;
-    int remainder = input_length % NUMBERS_FUNCTIONS_PARALLEL;
-    int sizes[NUMBERS_FUNCTIONS_PARALLEL];
-    int offsets[NUMBERS_FUNCTIONS_PARALLEL];
+    // The engines run side by side and the core is done with its slowest one: balance the chunks on
+    // predicted compression time, each starting on a cache line (and so on a memory word of the core).
+    PartitionOptions partition = {CACHE_LINE_BYTES, MAX_CHUNK_SIZE, -1, 1};
+    uint32_t sizes[NUMBER_PARALLEL_FUNCTIONS];
+    uint32_t offsets[NUMBER_PARALLEL_FUNCTIONS];
 
-    for (int i = 0; i < NUMBERS_FUNCTIONS_PARALLEL; i++) {
-        sizes[i] = part_size + (i < remainder ? 1 : 0);
-        offsets[i] = (i == 0) ? 0 : offsets[i-1] + sizes[i-1];
+    if (Partition_split(input, input_length, NUMBER_PARALLEL_FUNCTIONS, &partition, offsets, sizes) != 0) {
+        printf("Input of %d bytes does not fit in %d chunks\r\n", input_length, NUMBER_PARALLEL_FUNCTIONS);
+        return 1;
     }
 
-    for (int i = 0; i< NUMBERS_FUNCTIONS_PARALLEL; i++) {
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        descriptors[i].src = (uint32_t)((UINTPTR)input + offsets[i]);
+        descriptors[i].len = sizes[i];
+        descriptors[i].dst = (uint32_t)(UINTPTR)outputs[i];
+        descriptors[i].size_out = 0;
+
         Xil_DCacheFlushRange((UINTPTR)input + offsets[i], sizes[i]);
-        Xil_DCacheFlushRange((UINTPTR)outputs[i], input_length * 2);
+        Xil_DCacheFlushRange((UINTPTR)outputs[i], OUTPUT_BUFFER_SIZE);
     }
+    Xil_DCacheFlushRange((UINTPTR)descriptors, sizeof(descriptors));
 
     status = XTop_parallel_lzw_Initialize(&compressor, XPAR_TOP_PARALLEL_LZW_0_BASEADDR);
     if (status != XST_SUCCESS) {
@@ -154,38 +168,9 @@ int main() {
         return 1;
     }
 
-    XTop_parallel_lzw_Set_input1(&compressor, (UINTPTR)input + offsets[0]);
-    XTop_parallel_lzw_Set_input2(&compressor, (UINTPTR)input + offsets[1]);
-    XTop_parallel_lzw_Set_input3(&compressor, (UINTPTR)input + offsets[2]);
-    XTop_parallel_lzw_Set_input4(&compressor, (UINTPTR)input + offsets[3]);
-    XTop_parallel_lzw_Set_input5(&compressor, (UINTPTR)input + offsets[4]);
-    XTop_parallel_lzw_Set_input6(&compressor, (UINTPTR)input + offsets[5]);
-    XTop_parallel_lzw_Set_input7(&compressor, (UINTPTR)input + offsets[6]);
-    XTop_parallel_lzw_Set_input8(&compressor, (UINTPTR)input + offsets[7]);
-    XTop_parallel_lzw_Set_input9(&compressor, (UINTPTR)input + offsets[8]);
-    XTop_parallel_lzw_Set_input10(&compressor, (UINTPTR)input + offsets[9]);
-
-    XTop_parallel_lzw_Set_input_size1(&compressor, (UINTPTR)sizes[0]);
-    XTop_parallel_lzw_Set_input_size2(&compressor, (UINTPTR)sizes[1]);
-    XTop_parallel_lzw_Set_input_size3(&compressor, (UINTPTR)sizes[2]);
-    XTop_parallel_lzw_Set_input_size4(&compressor, (UINTPTR)sizes[3]);
-    XTop_parallel_lzw_Set_input_size5(&compressor, (UINTPTR)sizes[4]);
-    XTop_parallel_lzw_Set_input_size6(&compressor, (UINTPTR)sizes[5]);
-    XTop_parallel_lzw_Set_input_size7(&compressor, (UINTPTR)sizes[6]);
-    XTop_parallel_lzw_Set_input_size8(&compressor, (UINTPTR)sizes[7]);
-    XTop_parallel_lzw_Set_input_size9(&compressor, (UINTPTR)sizes[8]);
-    XTop_parallel_lzw_Set_input_size10(&compressor, (UINTPTR)sizes[9]);
-
-    XTop_parallel_lzw_Set_output1(&compressor,  (UINTPTR)outputs[0]);
-    XTop_parallel_lzw_Set_output2(&compressor,  (UINTPTR)outputs[1]);
-    XTop_parallel_lzw_Set_output3(&compressor,  (UINTPTR)outputs[2]);
-    XTop_parallel_lzw_Set_output4(&compressor,  (UINTPTR)outputs[3]);
-    XTop_parallel_lzw_Set_output5(&compressor,  (UINTPTR)outputs[4]);
-    XTop_parallel_lzw_Set_output6(&compressor,  (UINTPTR)outputs[5]);
-    XTop_parallel_lzw_Set_output7(&compressor,  (UINTPTR)outputs[6]);
-    XTop_parallel_lzw_Set_output8(&compressor,  (UINTPTR)outputs[7]);
-    XTop_parallel_lzw_Set_output9(&compressor,  (UINTPTR)outputs[8]);
-    XTop_parallel_lzw_Set_output10(&compressor,  (UINTPTR)outputs[9]);
+    XTop_parallel_lzw_Set_descriptors(&compressor, (UINTPTR)descriptors);
+    XTop_parallel_lzw_Set_memory_rd(&compressor, 0);
+    XTop_parallel_lzw_Set_memory_wr(&compressor, 0);
 
     start = get_global_time();
 
@@ -199,21 +184,15 @@ int main() {
 
     printf("Parallel compression time : %.6f seconds\r\n", elapsed_time_sec);
 
-    uint32_t compression_sizes[NUMBERS_FUNCTIONS_PARALLEL] = {0};
+    uint32_t compression_sizes[NUMBER_PARALLEL_FUNCTIONS] = {0};
     uint64_t total_compression_size = 0;
 
-    compression_sizes[0] = XTop_parallel_lzw_Get_compression_size1(&compressor);
-    compression_sizes[1] = XTop_parallel_lzw_Get_compression_size2(&compressor);
-    compression_sizes[2] = XTop_parallel_lzw_Get_compression_size3(&compressor);
-    compression_sizes[3] = XTop_parallel_lzw_Get_compression_size4(&compressor);
-    compression_sizes[4] = XTop_parallel_lzw_Get_compression_size5(&compressor);
-    compression_sizes[5] = XTop_parallel_lzw_Get_compression_size6(&compressor);
-    compression_sizes[6] = XTop_parallel_lzw_Get_compression_size7(&compressor);
-    compression_sizes[7] = XTop_parallel_lzw_Get_compression_size8(&compressor);
-    compression_sizes[8] = XTop_parallel_lzw_Get_compression_size9(&compressor);
-    compression_sizes[9] = XTop_parallel_lzw_Get_compression_size10(&compressor);
-
-    for (int i = 0; i < NUMBERS_FUNCTIONS_PARALLEL; i++) {
+    Xil_DCacheInvalidateRange((UINTPTR)descriptors, sizeof(descriptors));
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
+        compression_sizes[i] = descriptors[i].size_out;
+    }
+
+    for (int i = 0; i < NUMBER_PARALLEL_FUNCTIONS; i++) {
         Xil_DCacheInvalidateRange((UINTPTR)outputs[i], compression_sizes[i]);
         printf("Compression size of output number %d is : %lu\n", i+1, (unsigned long)compression_sizes[i]);
         total_compression_size += compression_sizes[i];
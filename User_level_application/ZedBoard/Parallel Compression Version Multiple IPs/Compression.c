@@ -1,4 +1,7 @@
 #include "xlzw_compress.h"
+#include "orchestrator.h"            // User_level_application/Common
+#include "partition.h"               // User_level_application/Common
+#include "trace.h"                   // User_level_application/Common
 #include "xparameters.h"
 #include "xil_cache.h"
 #include <stdint.h>
@@ -15,9 +18,12 @@
 #define NUMBER_OF_CORES 12
 #define FILE_INPUT_SIZE 4*1024*1024
 #define COUNTER_CLK_FREQ_HZ XPAR_CPU_CORE_CLOCK_FREQ_HZ/2
+#define CACHE_LINE_BYTES 32                    // L1/L2 line of the Cortex-A9
+/* Chunks are balanced on predicted time, not bytes: one may grow up to twice the equal share */
+#define MAX_CHUNK_SIZE (2 * (FILE_INPUT_SIZE / NUMBER_OF_CORES))
 
-static uint8_t input[FILE_INPUT_SIZE];
-uint8_t outputs[NUMBER_OF_CORES][2 * (FILE_INPUT_SIZE / NUMBER_OF_CORES)] = {{0}};
+static uint8_t input[FILE_INPUT_SIZE] __attribute__((aligned(CACHE_LINE_BYTES)));
+uint8_t outputs[NUMBER_OF_CORES][2 * MAX_CHUNK_SIZE] __attribute__((aligned(CACHE_LINE_BYTES))) = {{0}};
 
 UINTPTR base_addrs[NUMBER_OF_CORES] = {
     XPAR_LZW_COMPRESS_0_BASEADDR,
@@ -39,6 +45,11 @@ FATFS fatfs;
 static const TCHAR *Path = "0:";
 static char finput[32] = "input.txt";
 static char foutput[32] = "output.bin";
+static char ftrace[32] = "trace.csv";
+
+/* Phases of the run, see trace_gantt.py in User_level_application/Common */
+static Trace trace;
+static char trace_csv[16 * 1024];
 
 int ReadSD(uint8_t *input, int *input_length){
     FRESULT Res;
@@ -72,7 +83,13 @@ int ReadSD(uint8_t *input, int *input_length){
     return XST_SUCCESS;
 }
 
-int WriteSD(uint8_t outputs[NUMBER_OF_CORES][2 * (FILE_INPUT_SIZE / NUMBER_OF_CORES)], uint32_t compression_sizes[NUMBER_OF_CORES]) {
+/*
+ * output.bin: a text header "N size1 ... sizeN\n", then one line of "input_crc output_crc" pairs (hex, one per
+ * core), then the N compressed chunks back to back. A decoder can check each chunk against its output CRC and
+ * its decoded bytes against the input CRC.
+ */
+int WriteSD(uint8_t outputs[NUMBER_OF_CORES][2 * MAX_CHUNK_SIZE], uint32_t compression_sizes[NUMBER_OF_CORES],
+            uint32_t input_crcs[NUMBER_OF_CORES], uint32_t output_crcs[NUMBER_OF_CORES]) {
     FRESULT Res;
     UINT NumBytesWritten;
     UINT TotalNumBytesWritten = 0;
@@ -89,13 +106,18 @@ int WriteSD(uint8_t outputs[NUMBER_OF_CORES][2 * (FILE_INPUT_SIZE / NUMBER_OF_CO
         return XST_FAILURE;
     }
     
-    char header[128] = {0};
+    char header[384] = {0};
     UINT header_len = 0;
     header_len += snprintf(header + header_len, sizeof(header) - header_len, "%d", NUMBER_OF_CORES);
     for (int i = 0; i < NUMBER_OF_CORES; i++) {
         header_len += snprintf(header + header_len, sizeof(header) - header_len, " %u", compression_sizes[i]);
     }
     header_len += snprintf(header + header_len, sizeof(header) - header_len, "\n");
+    for (int i = 0; i < NUMBER_OF_CORES; i++) {
+        header_len += snprintf(header + header_len, sizeof(header) - header_len, "%s%08lx %08lx", i ? " " : "",
+                               (unsigned long)input_crcs[i], (unsigned long)output_crcs[i]);
+    }
+    header_len += snprintf(header + header_len, sizeof(header) - header_len, "\n");
 
     Res = f_write(&fil, header, header_len, &NumBytesWritten);
     if (Res != FR_OK || NumBytesWritten != header_len) {
@@ -122,6 +144,33 @@ int WriteSD(uint8_t outputs[NUMBER_OF_CORES][2 * (FILE_INPUT_SIZE / NUMBER_OF_CO
     return XST_SUCCESS;
 }
 
+/*
+ * trace.csv: the timeline of the run, one line per phase of each chunk. The SD card is already mounted by
+ * WriteSD.
+ */
+int WriteTraceSD(const Trace *trace) {
+    FRESULT Res;
+    UINT NumBytesWritten;
+    size_t length = Trace_format_csv(trace, trace_csv, sizeof(trace_csv));
+
+    Res = f_open(&fil, ftrace, FA_CREATE_ALWAYS | FA_WRITE);
+    if (Res != FR_OK){
+        printf("Open failed, error code %d\n", Res);
+        return XST_FAILURE;
+    }
+
+    Res = f_write(&fil, trace_csv, length, &NumBytesWritten);
+    f_close(&fil);
+    if (Res != FR_OK || NumBytesWritten != length) {
+        printf("Trace write failed, error code %d\n", Res);
+        return XST_FAILURE;
+    }
+
+    printf("Wrote %lu trace events to %s (%lu dropped)\n", (unsigned long)trace->count, ftrace,
+           (unsigned long)trace->dropped);
+    return XST_SUCCESS;
+}
+
 static inline uint64_t get_global_time() {
     volatile uint32_t *timer_lo = (volatile uint32_t *)(XPAR_PS7_GLOBALTIMER_0_BASEADDR);
     volatile uint32_t *timer_hi = (volatile uint32_t *)(XPAR_PS7_GLOBALTIMER_0_BASEADDR + 4);
@@ -134,6 +183,36 @@ static inline uint64_t get_global_time() {
     return ((uint64_t)hi1 << 32) | lo;
 }
 
+/* lzw_compress instances behind the orchestrator (User_level_application/Common) */
+static void core_start(void *core, const LzwChunk *chunk) {
+    XLzw_compress *compressor = core;
+    XLzw_compress_Set_input_r(compressor, (UINTPTR)chunk->input);
+    XLzw_compress_Set_output_r(compressor, (UINTPTR)chunk->output);
+    XLzw_compress_Set_input_size(compressor, chunk->length);
+    XLzw_compress_Start(compressor);
+}
+
+static int core_is_done(void *core) {
+    return XLzw_compress_IsDone((XLzw_compress *)core);
+}
+
+static void core_collect(void *core, LzwChunk *chunk) {
+    XLzw_compress *compressor = core;
+    chunk->compressed_size = XLzw_compress_Get_compression_size(compressor);
+    chunk->input_crc = XLzw_compress_Get_input_crc(compressor);
+    chunk->output_crc = XLzw_compress_Get_output_crc(compressor);
+}
+
+static void cache_flush(const void *buffer, size_t length) {
+    Xil_DCacheFlushRange((UINTPTR)buffer, length);
+}
+
+static void cache_invalidate(const void *buffer, size_t length) {
+    Xil_DCacheInvalidateRange((UINTPTR)buffer, length);
+}
+
+static const LzwCoreOps core_ops = {core_start, core_is_done, core_collect, cache_flush, cache_invalidate};
+
 void print_decimal(const uint8_t* data, uint32_t size) {
     for (uint32_t i = 0; i < size; i++) {
         printf("%u ", data[i]);
@@ -151,50 +230,47 @@ int main() {
 
     printf("\n-------------------------------------- Test 1 - 200 MHz - 12 IPs --------------------------------------\n");
 
+    Trace_init(&trace);
+
+    uint64_t read_begin = Trace_now();
     status = ReadSD(input, &input_length);
+    Trace_record(&trace, TRACE_READ, TRACE_NO_JOB, TRACE_NO_CORE, read_begin, Trace_now());
     if (status != XST_SUCCESS) {
         printf("Failed to read sd card, %d\r\n", status);
     }
 
-    int part_size = input_length / NUMBER_OF_CORES;
-    int remainder = input_length % NUMBER_OF_CORES;
-    int sizes[NUMBER_OF_CORES];
-    int offsets[NUMBER_OF_CORES];
-
-    for (int i = 0; i < NUMBER_OF_CORES; i++) {
-        sizes[i] = part_size + (i < remainder ? 1 : 0);
-        offsets[i] = (i == 0) ? 0 : offsets[i-1] + sizes[i-1];
-    }
-
+    void *cores[NUMBER_OF_CORES];
     for (int i = 0; i < NUMBER_OF_CORES; i++) {
         status = XLzw_compress_Initialize(&compressors[i], base_addrs[i]);
         if (status != XST_SUCCESS) {
             printf("Failed to initialize Lzw_compress HW, %d\r\n", status);
             return 1;
         }
+        cores[i] = &compressors[i];
+    }
 
-        Xil_DCacheFlushRange((UINTPTR)input + offsets[i], sizes[i]);
-        Xil_DCacheFlushRange((UINTPTR)outputs[i], sizes[i] * 2 );
-
-        XLzw_compress_Set_input_r(&compressors[i], (UINTPTR)input + offsets[i]);
-        XLzw_compress_Set_output_r(&compressors[i], (UINTPTR)outputs[i]);
-        XLzw_compress_Set_input_size(&compressors[i], sizes[i]);
+    // One chunk per core, balanced on predicted compression time and starting on a cache line so that the
+    // flush and invalidate of one chunk never touch the line of its neighbour.
+    PartitionOptions partition = {CACHE_LINE_BYTES, MAX_CHUNK_SIZE, -1, 1};
+    uint32_t offsets[NUMBER_OF_CORES], sizes[NUMBER_OF_CORES];
+    if (Partition_split(input, input_length, NUMBER_OF_CORES, &partition, offsets, sizes) != 0) {
+        printf("Input of %d bytes does not fit in %d chunks\r\n", input_length, NUMBER_OF_CORES);
+        return 1;
     }
 
+    // The orchestrator flushes and invalidates around each chunk.
+    LzwChunk chunks[NUMBER_OF_CORES];
+    Orchestrator_split(input, offsets, sizes, chunks, NUMBER_OF_CORES);
+    for (int i = 0; i < NUMBER_OF_CORES; i++) chunks[i].output = outputs[i];
+
 	// for (int i = 0; i < NUMBER_OF_CORES; i++) {
-	//     printf("Input data of chunk %d (%d bytes):\n", i, sizes[i]);
-	//     print_decimal(input+offsets[i], sizes[i]);       
+	//     printf("Input data of chunk %d (%lu bytes):\n", i, (unsigned long)chunks[i].length);
+	//     print_decimal(chunks[i].input, chunks[i].length);
 	// }
 
     start = get_global_time();
 
-    for (int i = 0; i < NUMBER_OF_CORES; i++) {
-        XLzw_compress_Start(&compressors[i]);
-    }
-
-    for (int i = 0; i < NUMBER_OF_CORES; i++) {
-        while (!XLzw_compress_IsDone(&compressors[i]));
-    }
+    uint64_t total_compression_size = Orchestrator_run(&core_ops, cores, NUMBER_OF_CORES, chunks, NUMBER_OF_CORES, &trace);
 
     end = get_global_time();
 
@@ -204,23 +280,31 @@ int main() {
     printf("Total compression time: %.6f seconds\r\n", elapsed_time_sec);
 
     uint32_t compression_sizes[NUMBER_OF_CORES];
-    uint64_t total_compression_size = 0;
+    uint32_t input_crcs[NUMBER_OF_CORES];
+    uint32_t output_crcs[NUMBER_OF_CORES];
 
     for (int i = 0; i < NUMBER_OF_CORES; i++) {
-        compression_sizes[i] = XLzw_compress_Get_compression_size(&compressors[i]);
+        compression_sizes[i] = chunks[i].compressed_size;
+        input_crcs[i] = chunks[i].input_crc;
+        output_crcs[i] = chunks[i].output_crc;
         //printf("Compression size of core %d is : %u\n", i, compression_sizes[i]);
-        Xil_DCacheInvalidateRange((UINTPTR)outputs[i], compression_sizes[i]);
-        total_compression_size += compression_sizes[i];
     }
 
     printf("Total compression size = %lu\n", (unsigned long)total_compression_size);
     printf("Compression ratio: %.2f%%\n", 100.0 * (double)total_compression_size / input_length);
 
-    status = WriteSD(outputs, compression_sizes);
+    uint64_t write_begin = Trace_now();
+    status = WriteSD(outputs, compression_sizes, input_crcs, output_crcs);
+    Trace_record(&trace, TRACE_WRITE, TRACE_NO_JOB, TRACE_NO_CORE, write_begin, Trace_now());
     if (status != XST_SUCCESS){
         printf("WriteSD failed, error code %d\n", status);
     }
 
+    status = WriteTraceSD(&trace);
+    if (status != XST_SUCCESS){
+        printf("WriteTraceSD failed, error code %d\n", status);
+    }
+
     // for (int i = 0; i < NUMBER_OF_CORES; i++) {
     //     printf("Core %d compressed output (%u bytes, decimal values):\n", i, compression_sizes[i]);
     //     print_decimal(outputs[i], compression_sizes[i]);